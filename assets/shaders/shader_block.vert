@@ -17,13 +17,15 @@ layout(binding = 0) uniform UniformBufferObject
     mat4 model;
     mat4 view;
     mat4 proj;
+    mat4 viewProj;
+    mat4 normal;
 } ubo;
 
 void main()
 {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPos, 1.0);
+    gl_Position = ubo.viewProj * ubo.model * vec4(inPos, 1.0);
     outFragColor = inColor;
     outfragTexCoord = inTexCoord;
-    outNormal = mat3(transpose(inverse(ubo.model))) * inNormal;
+    outNormal = mat3(ubo.normal) * inNormal;
     outFragPos = vec3(ubo.model * vec4(inPos, 1.0));
 }
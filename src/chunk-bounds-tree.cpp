@@ -0,0 +1,193 @@
+#include "chunk-bounds-tree.hpp"
+
+#include <bit>
+#include <limits>
+
+glm::ivec3 ChunkBoundsTree::getParentCoord(const glm::ivec3& coord)
+{
+    // Arithmetic shifts round towards negative infinity, so negative coordinates group the same way as positive ones.
+    return glm::ivec3(coord.x >> LOG2_BRANCHING, coord.y >> LOG2_BRANCHING, coord.z >> LOG2_BRANCHING);
+}
+
+unsigned ChunkBoundsTree::getChildBit(const glm::ivec3& coord)
+{
+    const glm::ivec3 local = coord & (BRANCHING - 1);
+    return static_cast<unsigned>(local.x + (local.y * BRANCHING) + (local.z * BRANCHING * BRANCHING));
+}
+
+glm::ivec3 ChunkBoundsTree::getChildCoord(const glm::ivec3& parent_coord, const unsigned bit)
+{
+    const int local = static_cast<int>(bit);
+    const glm::ivec3 local_coord(local % BRANCHING, (local / BRANCHING) % BRANCHING, local / (BRANCHING * BRANCHING));
+    return (parent_coord * BRANCHING) + local_coord;
+}
+
+void ChunkBoundsTree::updateParents(const glm::ivec3& coord)
+{
+    glm::ivec3 child_coord = coord;
+    for (size_t level = 1; level < NUM_LEVELS; ++level)
+    {
+        const glm::ivec3 parent_coord = getParentCoord(child_coord);
+        const uint64_t child_bit = uint64_t{1} << getChildBit(child_coord);
+        const bool child_exists = levels[level - 1].contains(child_coord);
+
+        auto it = levels[level].find(parent_coord);
+        if (it == levels[level].end())
+        {
+            if (!child_exists)
+            {
+                return;
+            }
+            it = levels[level].emplace(parent_coord, Node{}).first;
+        }
+
+        Node& parent = it->second;
+        parent.childMask = child_exists ? (parent.childMask | child_bit) : (parent.childMask & ~child_bit);
+        if (parent.childMask == 0)
+        {
+            levels[level].erase(it);
+            child_coord = parent_coord;
+            continue;
+        }
+
+        // Refit to the children since a child's bounds may have shrunk as well as grown.
+        parent.minBounds = glm::vec3(std::numeric_limits<float>::max());
+        parent.maxBounds = glm::vec3(std::numeric_limits<float>::lowest());
+        for (uint64_t mask = parent.childMask; mask != 0; mask &= mask - 1)
+        {
+            const unsigned bit = static_cast<unsigned>(std::countr_zero(mask));
+            const Node& child = levels[level - 1].at(getChildCoord(parent_coord, bit));
+            parent.minBounds = glm::min(parent.minBounds, child.minBounds);
+            parent.maxBounds = glm::max(parent.maxBounds, child.maxBounds);
+        }
+
+        child_coord = parent_coord;
+    }
+}
+
+void ChunkBoundsTree::addSubtree(
+    const size_t level,
+    const glm::ivec3& coord,
+    std::vector<glm::ivec3>& out_visible) const
+{
+    if (level == 0)
+    {
+        out_visible.push_back(coord);
+        return;
+    }
+
+    const Node& node = levels[level].at(coord);
+    for (uint64_t mask = node.childMask; mask != 0; mask &= mask - 1)
+    {
+        const unsigned bit = static_cast<unsigned>(std::countr_zero(mask));
+        addSubtree(level - 1, getChildCoord(coord, bit), out_visible);
+    }
+}
+
+void ChunkBoundsTree::cullNode(
+    const size_t level,
+    const glm::ivec3& coord,
+    const Frustum& frustum,
+    std::vector<glm::ivec3>& out_visible)
+{
+    Node& node = levels[level].at(coord);
+    switch (frustum.classifyAabb(Aabb3d(node.minBounds, node.maxBounds), &node.planeHint))
+    {
+    case Frustum::Intersection::OUTSIDE: {
+        break;
+    }
+    case Frustum::Intersection::INSIDE: {
+        addSubtree(level, coord, out_visible);
+        break;
+    }
+    case Frustum::Intersection::INTERSECTING: {
+        if (level == 1)
+        {
+            cullChunks(coord, frustum, out_visible);
+            break;
+        }
+        for (uint64_t mask = node.childMask; mask != 0; mask &= mask - 1)
+        {
+            const unsigned bit = static_cast<unsigned>(std::countr_zero(mask));
+            cullNode(level - 1, getChildCoord(coord, bit), frustum, out_visible);
+        }
+        break;
+    }
+    }
+}
+
+void ChunkBoundsTree::cullChunks(
+    const glm::ivec3& parent_coord,
+    const Frustum& frustum,
+    std::vector<glm::ivec3>& out_visible)
+{
+    // A node has at most 64 chunks, so they are all tested in one batch and their visibility fits in one word.
+    childBounds.clear();
+    childCoords.clear();
+    childPlaneHints.clear();
+    for (uint64_t mask = levels[1].at(parent_coord).childMask; mask != 0; mask &= mask - 1)
+    {
+        const unsigned bit = static_cast<unsigned>(std::countr_zero(mask));
+        const glm::ivec3 coord = getChildCoord(parent_coord, bit);
+        const Node& chunk = levels[0].at(coord);
+        childBounds.add(chunk.minBounds, chunk.maxBounds);
+        childCoords.push_back(coord);
+        childPlaneHints.push_back(chunk.planeHint);
+    }
+
+    frustum.cullAabbs(childBounds, childVisibility, &childPlaneHints);
+
+    for (size_t i = 0; i < childCoords.size(); ++i)
+    {
+        levels[0].at(childCoords[i]).planeHint = childPlaneHints[i];
+        if ((childVisibility[0] >> i) & 1u)
+        {
+            out_visible.push_back(childCoords[i]);
+        }
+    }
+}
+
+void ChunkBoundsTree::insert(const glm::ivec3& chunk_coord, const Aabb3d& bounds)
+{
+    Node& chunk = levels[0][chunk_coord];
+    chunk.minBounds = bounds.getMinBounds();
+    chunk.maxBounds = bounds.getMaxBounds();
+
+    updateParents(chunk_coord);
+}
+
+void ChunkBoundsTree::erase(const glm::ivec3& chunk_coord)
+{
+    if (levels[0].erase(chunk_coord) == 0)
+    {
+        return;
+    }
+
+    updateParents(chunk_coord);
+}
+
+void ChunkBoundsTree::clear()
+{
+    for (auto& level : levels)
+    {
+        level.clear();
+    }
+}
+
+void ChunkBoundsTree::cull(const Frustum& frustum, std::vector<glm::ivec3>& out_visible)
+{
+    for (const auto& [coord, node] : levels[NUM_LEVELS - 1])
+    {
+        cullNode(NUM_LEVELS - 1, coord, frustum, out_visible);
+    }
+}
+
+bool ChunkBoundsTree::contains(const glm::ivec3& chunk_coord) const
+{
+    return levels[0].contains(chunk_coord);
+}
+
+size_t ChunkBoundsTree::size() const
+{
+    return levels[0].size();
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "engine/frustum.hpp"
+#include "engine/physics/shapes/aabb-batch.hpp"
+
+#include "engine/usage/glm-usage.hpp"
+#include <glm/gtx/hash.hpp>
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Hierarchy of chunk bounds for frustum culling, keyed by chunk coordinate (chunk center / chunk size).
+// Each node above the leaves covers a cube of `BRANCHING`^3 nodes of the level below, so a node's children fit in a
+// 64-bit mask, and its bounds are the union of its children's. Only chunks with something to draw are inserted, with
+// bounds fitted to their mesh, so empty (e.g. sky) chunks and nodes never count as visible.
+// Culling goes top-down: a node outside the frustum rejects its whole subtree and a node entirely inside accepts it
+// without further tests.
+class ChunkBoundsTree
+{
+  private:
+    static constexpr int LOG2_BRANCHING = 2;
+    static constexpr int BRANCHING = 1 << LOG2_BRANCHING;
+    static constexpr size_t NUM_LEVELS = 3; // Chunks, then nodes of 4^3 chunks, then nodes of 16^3 chunks.
+
+    struct Node
+    {
+        glm::vec3 minBounds;
+        glm::vec3 maxBounds;
+        uint64_t childMask = 0; // Bit `x + 4y + 16z` is set if the child at local coordinate (x, y, z) exists.
+        uint8_t planeHint = 0;  // Frustum plane that last rejected this node.
+    };
+
+    // Indexed by level; level 0 holds the chunks.
+    std::array<std::unordered_map<glm::ivec3, Node>, NUM_LEVELS> levels;
+
+    // Scratch space for culling the chunks of a node in one batch.
+    Aabb3dBatch childBounds;
+    std::vector<glm::ivec3> childCoords;
+    std::vector<uint8_t> childPlaneHints;
+    std::vector<uint64_t> childVisibility;
+
+    static glm::ivec3 getParentCoord(const glm::ivec3& coord);
+    static unsigned getChildBit(const glm::ivec3& coord);
+    static glm::ivec3 getChildCoord(const glm::ivec3& parent_coord, const unsigned bit);
+
+    void updateParents(const glm::ivec3& coord);
+    void addSubtree(const size_t level, const glm::ivec3& coord, std::vector<glm::ivec3>& out_visible) const;
+    void cullNode(
+        const size_t level,
+        const glm::ivec3& coord,
+        const Frustum& frustum,
+        std::vector<glm::ivec3>& out_visible);
+    void cullChunks(const glm::ivec3& parent_coord, const Frustum& frustum, std::vector<glm::ivec3>& out_visible);
+
+  public:
+    void insert(const glm::ivec3& chunk_coord, const Aabb3d& bounds); // Also updates the bounds of existing chunks.
+    void erase(const glm::ivec3& chunk_coord);
+    void clear();
+
+    // Appends the coordinates of the chunks that are at least partly inside the frustum.
+    void cull(const Frustum& frustum, std::vector<glm::ivec3>& out_visible);
+
+    bool contains(const glm::ivec3& chunk_coord) const;
+    size_t size() const;
+};
@@ -0,0 +1,364 @@
+#include "chunk-cache.hpp"
+
+#include "engine/metrics.hpp"
+#include "engine/profiler.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+constexpr std::array<char, 8> MAGIC = {'V', 'M', 'C', 'C', 'H', 'U', 'N', 'K'};
+constexpr uint32_t FORMAT_VERSION = 1;
+
+// Visible blocks are stored as 16-bit local indices, which covers chunks up to 40 blocks wide.
+constexpr size_t MAX_NUM_BLOCKS = size_t{std::numeric_limits<uint16_t>::max()} + 1;
+
+VmcMetrics::Counter& chunk_cache_hits_counter = VmcMetrics::getCounter("chunk_cache_hits");
+VmcMetrics::Counter& chunk_cache_misses_counter = VmcMetrics::getCounter("chunk_cache_misses");
+
+// Everything before the runs; written and read field by field so the layout doesn't depend on padding.
+struct Header
+{
+    std::array<char, 8> magic = MAGIC;
+    uint32_t formatVersion = FORMAT_VERSION;
+    uint32_t generatorVersion = Chunk::GENERATOR_VERSION;
+    uint32_t seed = 0;
+    glm::vec3 center{};
+    int32_t size = 0;
+    int32_t blockCount = 0;
+    uint32_t numRuns = 0; // 0 if the chunk has no block container.
+    uint32_t numVisibleBlocks = 0;
+};
+
+template <typename T>
+void appendValue(std::vector<char>& bytes, const T& value)
+{
+    const char* const begin = reinterpret_cast<const char*>(&value);
+    bytes.insert(bytes.end(), begin, begin + sizeof(value));
+}
+
+class ByteReader
+{
+  private:
+    const char* curr;
+    const char* end;
+
+  public:
+    ByteReader(const char* data, const size_t size) : curr(data), end(data + size)
+    {
+    }
+
+    template <typename T>
+    bool read(T& value)
+    {
+        if (static_cast<size_t>(end - curr) < sizeof(value))
+        {
+            return false;
+        }
+        std::memcpy(&value, curr, sizeof(value));
+        curr += sizeof(value);
+        return true;
+    }
+};
+
+// Read-only view of a whole file; empty if the file doesn't exist or couldn't be mapped.
+class MappedFile
+{
+  private:
+    const char* data = nullptr;
+    size_t size = 0;
+
+  public:
+    explicit MappedFile(const std::filesystem::path& path)
+    {
+#if defined(_WIN32)
+        const HANDLE file = CreateFileW(
+            path.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ | FILE_SHARE_DELETE,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+        LARGE_INTEGER file_size{};
+        if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+        {
+            const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping != nullptr)
+            {
+                // The view keeps the file mapped after both handles are closed.
+                data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                size = (data != nullptr) ? static_cast<size_t>(file_size.QuadPart) : 0;
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+#else
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return;
+        }
+        struct stat file_stat{};
+        if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0)
+        {
+            // The mapping stays valid after the descriptor is closed.
+            void* const mapped = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED)
+            {
+                data = static_cast<const char*>(mapped);
+                size = static_cast<size_t>(file_stat.st_size);
+            }
+        }
+        close(fd);
+#endif
+    }
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile(MappedFile&& other) = delete;
+
+    ~MappedFile()
+    {
+        if (data == nullptr)
+        {
+            return;
+        }
+#if defined(_WIN32)
+        UnmapViewOfFile(data);
+#else
+        munmap(const_cast<char*>(data), size);
+#endif
+    }
+
+    MappedFile& operator=(const MappedFile& other) = delete;
+    MappedFile& operator=(MappedFile&& other) = delete;
+
+    const char* getData() const
+    {
+        return data;
+    }
+
+    size_t getSize() const
+    {
+        return size;
+    }
+};
+
+} // namespace
+
+ChunkCache::ChunkCache(const std::filesystem::path& root_directory, const unsigned seed)
+    : directory(root_directory /
+                ("seed-" + std::to_string(seed) + "-v" + std::to_string(Chunk::GENERATOR_VERSION))),
+      seed(seed)
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    isDirectoryCreated = !error;
+}
+
+std::filesystem::path ChunkCache::getChunkPath(const ChunkCenter& cc) const
+{
+    return directory / (std::to_string(static_cast<int>(std::floor(cc.x))) + "_" +
+                        std::to_string(static_cast<int>(std::floor(cc.y))) + "_" +
+                        std::to_string(static_cast<int>(std::floor(cc.z))) + ".chunk");
+}
+
+bool ChunkCache::isOpen() const
+{
+    return isDirectoryCreated;
+}
+
+Chunk* ChunkCache::load(const FastNoiseLite& height_noise, const ChunkCenter& cc, const int chunk_size)
+{
+    VMC_PROFILE_ZONE("ChunkCache::load");
+
+    const auto miss = [this]() -> Chunk* {
+        numMisses.fetch_add(1, std::memory_order_relaxed);
+        chunk_cache_misses_counter.add();
+        return nullptr;
+    };
+
+    if (!isDirectoryCreated)
+    {
+        return miss();
+    }
+
+    const MappedFile file(getChunkPath(cc));
+    ByteReader reader(file.getData(), file.getSize());
+
+    Header header;
+    if (!reader.read(header.magic) || header.magic != MAGIC || !reader.read(header.formatVersion) ||
+        header.formatVersion != FORMAT_VERSION || !reader.read(header.generatorVersion) ||
+        header.generatorVersion != Chunk::GENERATOR_VERSION || !reader.read(header.seed) || header.seed != seed ||
+        !reader.read(header.center) || header.center != cc || !reader.read(header.size) ||
+        header.size != chunk_size || !reader.read(header.blockCount) || !reader.read(header.numRuns) ||
+        !reader.read(header.numVisibleBlocks))
+    {
+        return miss(); // Missing, or left over from another format or (unlikely given the path) generator.
+    }
+
+    std::unique_ptr<Chunk> chunk(new Chunk(height_noise, cc, chunk_size, false)); // The constructor is private.
+    chunk->blockCount = header.blockCount;
+
+    if (header.numRuns > 0)
+    {
+        chunk->initContainer();
+        Chunk::BlockContainer& blocks = *chunk->blocks;
+
+        size_t index = 0;
+        for (uint32_t i = 0; i < header.numRuns; ++i)
+        {
+            uint8_t type = 0;
+            uint16_t length = 0;
+            if (!reader.read(type) || !reader.read(length) || length > blocks.size() - index)
+            {
+                return miss();
+            }
+            std::fill_n(blocks.begin() + index, length, static_cast<Chunk::BlockType>(type));
+            index += length;
+        }
+        if (index != blocks.size())
+        {
+            return miss();
+        }
+    }
+
+    const size_t num_blocks = static_cast<size_t>(chunk_size) * chunk_size * chunk_size;
+    chunk->visibleBlocks.reserve(header.numVisibleBlocks);
+    for (uint32_t i = 0; i < header.numVisibleBlocks; ++i)
+    {
+        uint16_t index = 0;
+        if (!reader.read(index) || index >= num_blocks)
+        {
+            return miss();
+        }
+        const int x = index % chunk_size;
+        const int y = (index / chunk_size) % chunk_size;
+        const int z = index / (chunk_size * chunk_size);
+        chunk->visibleBlocks.emplace(chunk->minBounds + glm::vec3(x, y, z));
+    }
+
+    numHits.fetch_add(1, std::memory_order_relaxed);
+    chunk_cache_hits_counter.add();
+    return chunk.release();
+}
+
+bool ChunkCache::store(const Chunk& chunk) const
+{
+    VMC_PROFILE_ZONE("ChunkCache::store");
+
+    const size_t num_blocks = static_cast<size_t>(chunk.size) * chunk.size * chunk.size;
+    if (!isDirectoryCreated || num_blocks > MAX_NUM_BLOCKS)
+    {
+        return false;
+    }
+
+    std::vector<char> bytes;
+    std::vector<char> runs;
+    uint32_t num_runs = 0;
+    if (chunk.blocks != nullptr)
+    {
+        const Chunk::BlockContainer& blocks = *chunk.blocks;
+        for (size_t begin = 0; begin < blocks.size();)
+        {
+            size_t end = begin + 1;
+            while (end < blocks.size() && blocks[end] == blocks[begin] &&
+                   end - begin < std::numeric_limits<uint16_t>::max())
+            {
+                ++end;
+            }
+            appendValue(runs, static_cast<uint8_t>(blocks[begin]));
+            appendValue(runs, static_cast<uint16_t>(end - begin));
+            ++num_runs;
+            begin = end;
+        }
+    }
+
+    Header header;
+    header.seed = seed;
+    header.center = chunk.center;
+    header.size = chunk.size;
+    header.blockCount = chunk.blockCount;
+    header.numRuns = num_runs;
+    header.numVisibleBlocks = static_cast<uint32_t>(chunk.visibleBlocks.size());
+
+    appendValue(bytes, header.magic);
+    appendValue(bytes, header.formatVersion);
+    appendValue(bytes, header.generatorVersion);
+    appendValue(bytes, header.seed);
+    appendValue(bytes, header.center);
+    appendValue(bytes, header.size);
+    appendValue(bytes, header.blockCount);
+    appendValue(bytes, header.numRuns);
+    appendValue(bytes, header.numVisibleBlocks);
+    bytes.insert(bytes.end(), runs.begin(), runs.end());
+    for (const glm::vec3& block_pos : chunk.visibleBlocks)
+    {
+        appendValue(bytes, static_cast<uint16_t>(chunk.getBlockIndex(block_pos)));
+    }
+
+    // Write to a name of this thread's own, then move it into place in one step.
+    const std::filesystem::path path = getChunkPath(chunk.center);
+    std::filesystem::path temp_path = path;
+    temp_path += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.write(bytes.data(), static_cast<std::streamsize>(bytes.size())))
+        {
+            file.close();
+            std::error_code error;
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+    return true;
+}
+
+const std::filesystem::path& ChunkCache::getDirectory() const
+{
+    return directory;
+}
+
+uint64_t ChunkCache::getNumHits() const
+{
+    return numHits.load(std::memory_order_relaxed);
+}
+
+uint64_t ChunkCache::getNumMisses() const
+{
+    return numMisses.load(std::memory_order_relaxed);
+}
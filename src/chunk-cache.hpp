@@ -0,0 +1,42 @@
+#pragma once
+
+#include "chunk.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+
+// On-disk cache of freshly generated chunks, so terrain that was generated before (by any earlier session with the same
+// seed) is loaded instead of being generated again. Chunks are stored as generated and never with player edits.
+//
+// Every chunk is a file in a directory named after the seed and `Chunk::GENERATOR_VERSION`, so changing the generator
+// invalidates the cache without having to clear it. A file holds a small header, the blocks run-length encoded and the
+// local indices of the visible blocks; files are written to a temporary name and renamed so readers never see partial
+// ones, and are read through a memory mapping. Loading and storing are safe to call from several threads at once.
+class ChunkCache
+{
+  private:
+    std::filesystem::path directory;
+    unsigned seed;
+    bool isDirectoryCreated = false;
+
+    std::atomic<uint64_t> numHits = 0;
+    std::atomic<uint64_t> numMisses = 0;
+
+    std::filesystem::path getChunkPath(const ChunkCenter& cc) const;
+
+  public:
+    ChunkCache(const std::filesystem::path& root_directory, const unsigned seed);
+
+    bool isOpen() const; // False if the directory couldn't be created; nothing is cached then.
+
+    // Null if the chunk isn't cached or its file can't be used; the caller owns the returned chunk.
+    Chunk* load(const FastNoiseLite& height_noise, const ChunkCenter& cc, const int chunk_size);
+
+    // Only meant for chunks straight out of generation; returns false if the chunk couldn't be written.
+    bool store(const Chunk& chunk) const;
+
+    const std::filesystem::path& getDirectory() const;
+    uint64_t getNumHits() const;
+    uint64_t getNumMisses() const;
+};
@@ -0,0 +1,81 @@
+#include "chunk-registry.hpp"
+
+#include <mutex>
+
+size_t ChunkRegistry::getShardIndex(const ChunkCenter& cc) const
+{
+    // Hash the chunk coordinate (not the block position) so that neighboring chunks spread across shards.
+    const glm::ivec3 coord = glm::ivec3(glm::round(cc / static_cast<float>(chunkSize)));
+    const size_t hash = (static_cast<size_t>(coord.x) * 73856093u) ^ (static_cast<size_t>(coord.y) * 19349663u) ^
+                        (static_cast<size_t>(coord.z) * 83492791u);
+    return hash & (NUM_SHARDS - 1);
+}
+
+ChunkRegistry::ChunkRegistry(const int chunk_size) : chunkSize(chunk_size)
+{
+}
+
+Chunk* ChunkRegistry::find(const ChunkCenter& cc) const
+{
+    const Shard& shard = shards[getShardIndex(cc)];
+
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+    const auto it = shard.chunks.find(cc);
+    return (it != shard.chunks.end()) ? it->second : nullptr;
+}
+
+bool ChunkRegistry::contains(const ChunkCenter& cc) const
+{
+    return find(cc) != nullptr;
+}
+
+bool ChunkRegistry::insert(const ChunkCenter& cc, Chunk* chunk)
+{
+    Shard& shard = shards[getShardIndex(cc)];
+
+    std::lock_guard<std::shared_mutex> lock(shard.mutex);
+
+    const bool inserted = shard.chunks.emplace(cc, chunk).second;
+    if (inserted)
+    {
+        ++count;
+    }
+    return inserted;
+}
+
+Chunk* ChunkRegistry::erase(const ChunkCenter& cc)
+{
+    Shard& shard = shards[getShardIndex(cc)];
+
+    std::lock_guard<std::shared_mutex> lock(shard.mutex);
+
+    const auto it = shard.chunks.find(cc);
+    if (it == shard.chunks.end())
+    {
+        return nullptr;
+    }
+
+    Chunk* chunk = it->second;
+    shard.chunks.erase(it);
+    --count;
+    return chunk;
+}
+
+void ChunkRegistry::forEach(const std::function<void(Chunk*)>& callback) const
+{
+    for (const auto& shard : shards)
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+        for (const auto& entry : shard.chunks)
+        {
+            callback(entry.second);
+        }
+    }
+}
+
+size_t ChunkRegistry::size() const
+{
+    return count;
+}
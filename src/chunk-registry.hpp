@@ -0,0 +1,49 @@
+#pragma once
+
+#include "chunk.hpp"
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <shared_mutex>
+#include <unordered_map>
+
+// Thread-safe map of chunk centers to chunks.
+// The map is split into shards by chunk coordinate, each with its own lock, so a lookup only waits on a writer that is
+// inserting into the same shard, and only for the duration of the insertion itself.
+// Chunks are never evicted while the world is alive, so a returned pointer stays valid without any reclamation scheme.
+class ChunkRegistry
+{
+  private:
+    static constexpr size_t NUM_SHARDS = 64; // Must be a power of 2.
+
+    struct Shard
+    {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<ChunkCenter, Chunk*> chunks;
+    };
+
+    std::array<Shard, NUM_SHARDS> shards;
+    std::atomic<size_t> count = 0;
+    int chunkSize; // In blocks.
+
+    size_t getShardIndex(const ChunkCenter& cc) const;
+
+  public:
+    ChunkRegistry(const int chunk_size);
+    ChunkRegistry(const ChunkRegistry& other) = delete;
+    ChunkRegistry(ChunkRegistry&& other) = delete;
+
+    ChunkRegistry& operator=(const ChunkRegistry& other) = delete;
+    ChunkRegistry& operator=(ChunkRegistry&& other) = delete;
+
+    Chunk* find(const ChunkCenter& cc) const;
+    bool contains(const ChunkCenter& cc) const;
+
+    bool insert(const ChunkCenter& cc, Chunk* chunk);
+    Chunk* erase(const ChunkCenter& cc);
+
+    void forEach(const std::function<void(Chunk*)>& callback) const;
+
+    size_t size() const;
+};
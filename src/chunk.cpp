@@ -1,6 +1,6 @@
 #include "chunk.hpp"
 
-#include "engine/physics/collision-handler.hpp"
+#include "engine/profiler.hpp"
 
 #include <algorithm>
 
@@ -20,6 +20,8 @@ void Chunk::initContainer()
 
 void Chunk::init()
 {
+    VMC_PROFILE_ZONE("Chunk::init");
+
     blockCount = 0;
 
     const glm::ivec3 start = static_cast<glm::ivec3>(minBounds);
@@ -33,7 +35,7 @@ void Chunk::init()
     initContainer();
 
     // Generate blocks.
-    std::unordered_set<glm::vec3> neighboring_chunk_blocks;
+    VisibleBlockSet neighboring_chunk_blocks;
     constexpr int neighbor_chunk_offset = 2;
     for (int z = start.z - neighbor_chunk_offset; z <= end.z + neighbor_chunk_offset; ++z)
     {
@@ -188,8 +190,8 @@ bool Chunk::isBlockHidden(const glm::vec3& global_pos) const
     for (size_t i = 0; i < offsets.size(); ++i)
     {
         const glm::vec3 neighbor = global_pos + offsets[i];
-        if (!isBlockPresent(neighbor) && (neighboringChunks[i] != nullptr) &&
-            !neighboringChunks[i]->isBlockPresent(neighbor))
+        const Chunk* neighboring_chunk = getNeighboringChunk(static_cast<Axis>(i));
+        if (!isBlockPresent(neighbor) && (neighboring_chunk != nullptr) && !neighboring_chunk->isBlockPresent(neighbor))
         {
             // There must be a visible face; therefore, a visible block.
             return false;
@@ -198,7 +200,7 @@ bool Chunk::isBlockHidden(const glm::vec3& global_pos) const
     return true;
 }
 
-bool Chunk::isBlockHidden(const glm::vec3& global_pos, const std::unordered_set<glm::vec3>& neighboring_blocks) const
+bool Chunk::isBlockHidden(const glm::vec3& global_pos, const VisibleBlockSet& neighboring_blocks) const
 {
     const std::vector<glm::vec3> offsets = {
         glm::vec3(1.0, 0.0, 0.0),  // +x
@@ -228,14 +230,26 @@ bool Chunk::isInChunkBounds(const glm::vec3& global_pos) const
     return in_x_bounds && in_y_bounds && in_z_bounds;
 }
 
-Chunk::Chunk(const FastNoiseLite& height_noise, const glm::vec3& center_pos, const int size)
+Chunk::Chunk(
+    const FastNoiseLite& height_noise,
+    const glm::vec3& center_pos,
+    const int size,
+    const bool should_generate)
     : center(center_pos), size(size), heightNoise(height_noise)
 {
     const float half_size = (static_cast<float>(size) * 0.5f);
     minBounds = center_pos - glm::vec3(half_size);
     maxBounds = center_pos + glm::vec3(half_size - 1.0f);
 
-    init();
+    if (should_generate)
+    {
+        init();
+    }
+}
+
+Chunk::Chunk(const FastNoiseLite& height_noise, const glm::vec3& center_pos, const int size)
+    : Chunk(height_noise, center_pos, size, true)
+{
 }
 
 void Chunk::addBlock(const glm::vec3& global_pos)
@@ -311,17 +325,19 @@ void Chunk::removeBlock(const glm::vec3& global_pos)
         {
             visibleBlocks.emplace(neighbor);
         }
-        else if (!isInChunkBounds(neighbor) && neighboringChunks[i] != nullptr)
+        else if (!isInChunkBounds(neighbor) && getNeighboringChunk(static_cast<Axis>(i)) != nullptr)
         {
+            Chunk* neighboring_chunk = getNeighboringChunk(static_cast<Axis>(i));
+
             // TODO: instead of regenerating if needed, try to get it from persistent storage.
             // TODO: don't like how a chunk can modify its neighbors.
-            if (neighboringChunks[i]->blockCount > 0 && neighboringChunks[i]->blocks == nullptr)
+            if (neighboring_chunk->blockCount > 0 && neighboring_chunk->blocks == nullptr)
             {
-                neighboringChunks[i]->init();
+                neighboring_chunk->init();
             }
-            if (neighboringChunks[i]->isBlockPresent(neighbor) && !neighboringChunks[i]->isBlockVisible(neighbor))
+            if (neighboring_chunk->isBlockPresent(neighbor) && !neighboring_chunk->isBlockVisible(neighbor))
             {
-                neighboringChunks[i]->visibleBlocks.emplace(neighbor);
+                neighboring_chunk->visibleBlocks.emplace(neighbor);
             }
         }
     }
@@ -333,6 +349,17 @@ void Chunk::removeBlock(const glm::vec3& global_pos)
     }
 }
 
+Chunk* Chunk::getNeighboringChunk(const Axis axis) const
+{
+    // Acquire so that the neighbor's blocks are visible once its pointer is.
+    return neighboringChunks[axis].load(std::memory_order_acquire);
+}
+
+void Chunk::setNeighboringChunk(const Axis axis, Chunk* chunk)
+{
+    neighboringChunks[axis].store(chunk, std::memory_order_release);
+}
+
 bool Chunk::isBlockOnEdge(const glm::vec3& global_pos, const Axis axis) const
 {
     // 3 represents the 1st 3 positive axes in the enumeration.
@@ -346,101 +373,67 @@ bool Chunk::isBlockOnEdge(const glm::vec3& global_pos) const
            isBlockOnEdge(global_pos, Axis::POS_Z) || isBlockOnEdge(global_pos, Axis::NEG_Z);
 }
 
-const std::optional<glm::vec3> Chunk::getReachableBlock(const Ray& ray, glm::ivec3* face_entered) const
+bool Chunk::hasAllNeighboringChunks() const
 {
-    if (face_entered != nullptr)
-    {
-        *face_entered = glm::ivec3(0);
-    }
-
-    std::optional<glm::vec3> reachable_block_pos;
-
-    // Find which block the player can reach.
-    // TODO: reduce the visible blocks to check by using the player's reach and position in this chunk instead of
-    // evaluating all visible blocks in the chunk.
-    float min_dist = std::numeric_limits<float>::infinity();
-    for (const auto& block_pos : visibleBlocks)
+    for (size_t i = 0; i < neighboringChunks.size(); ++i)
     {
-        float t_min = min_dist; // Can be any value; it will be modified by the intersection test.
-        glm::ivec3 curr_face_entered{};
-        const bool intersected = CollisionHandler::rayToShapeIntersect(
-            ray,
-            Aabb3d(glm::vec3(block_pos) - glm::vec3(0.5f), glm::vec3(block_pos) + glm::vec3(0.5f)),
-            &t_min,
-            nullptr,
-            &curr_face_entered);
-
-        if (intersected && (t_min < min_dist))
+        if (getNeighboringChunk(static_cast<Axis>(i)) == nullptr)
         {
-            reachable_block_pos = block_pos;
-            min_dist = t_min;
-            if (face_entered != nullptr)
-            {
-                *face_entered = curr_face_entered;
-            }
+            return false;
         }
     }
-
-    return reachable_block_pos;
+    return true;
 }
 
-bool Chunk::doesEntityIntersect(
-    const glm::vec3& velocity,
-    const float delta,
-    const Aabb3d& hitbox,
-    float& new_delta,
-    glm::vec3* normal) const
+Chunk::State Chunk::getState() const
 {
-    new_delta = delta;
-
-    bool intersected = false;
-    glm::vec3 closest_normal{};
-    const Aabb3d broad_phase_aabb = CollisionHandler::getBroadPhaseAabb(hitbox, velocity, delta);
+    return state.load(std::memory_order_acquire);
+}
 
-    for (const auto& block_pos : visibleBlocks)
-    {
-        const Aabb3d block_hitbox(glm::vec3(block_pos) - glm::vec3(0.5f), glm::vec3(block_pos) + glm::vec3(0.5f));
+void Chunk::setState(const State new_state)
+{
+    // Release so that the work done for `new_state` (e.g. the mesh) is visible to whoever observes it.
+    state.store(new_state, std::memory_order_release);
+}
 
-        // Check whether to ignore the current block given the broad phase AABB.
-        if (!CollisionHandler::shapeToShapeIntersect(broad_phase_aabb, block_hitbox))
-        {
-            continue;
-        }
+bool Chunk::advanceState(const State expected_state, const State new_state)
+{
+    State expected = expected_state;
+    return state.compare_exchange_strong(expected, new_state, std::memory_order_acq_rel);
+}
 
-        glm::vec3 curr_normal{};
-        const float t_min = CollisionHandler::sweptAabbPerAxis(hitbox, block_hitbox, velocity, delta, curr_normal);
+ChunkCenter Chunk::getCenter() const
+{
+    return center;
+}
 
-        assert(t_min >= 0.0f);
-        if (t_min != std::numeric_limits<float>::infinity())
+uint64_t Chunk::getBlocksHash() const
+{
+    // 64-bit FNV-1a.
+    uint64_t hash = 14695981039346656037ull;
+    const auto hash_bytes = [&hash](const void* data, const size_t num_bytes) {
+        const unsigned char* const bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < num_bytes; ++i)
         {
-            // Get the minimum because it represents the closest collision.
-            if (t_min < new_delta)
-            {
-                new_delta = t_min;
-                closest_normal = curr_normal;
-            }
-            intersected = true;
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
         }
-    }
+    };
 
-    // Update modifiable parameters.
-    if (normal != nullptr)
+    hash_bytes(&center, sizeof(center));
+    hash_bytes(&blockCount, sizeof(blockCount));
+    if (blocks != nullptr)
     {
-        *normal = closest_normal;
+        hash_bytes(blocks->data(), blocks->size() * sizeof(BlockType));
     }
-
-    return intersected;
-}
-
-ChunkCenter Chunk::getCenter() const
-{
-    return center;
+    return hash;
 }
 
 const Model Chunk::getModel() const
 {
-    std::vector<Model::Vertex> vertices;
-    std::vector<Model::Index> indices;
+    VMC_PROFILE_ZONE("Chunk::getModel");
+
+    Model::VertexContainer vertices;
+    Model::IndexContainer indices;
 
     constexpr std::array<glm::vec3, 6> offsets = {
         glm::vec3(1.0f, 0.0f, 0.0f),  // +x
@@ -472,9 +465,10 @@ const Model Chunk::getModel() const
             // If the neighbor is present in this chunk, then there is a neighbor,
             // otherwise, if the neighbor is not in this chunk bounds and (the neighboring chunk `i` is not null or the
             // neighbor is present in the neighboring chunk), then we consider that there is a neighbor.
+            const Chunk* neighboring_chunk = getNeighboringChunk(static_cast<Axis>(i));
             const bool has_neighbor = isBlockPresent(neighbor) ||
-                                      (!isInChunkBounds(neighbor) && ((neighboringChunks[i] == nullptr) ||
-                                                                      neighboringChunks[i]->isBlockPresent(neighbor)));
+                                      (!isInChunkBounds(neighbor) && ((neighboring_chunk == nullptr) ||
+                                                                      neighboring_chunk->isBlockPresent(neighbor)));
             if (!has_neighbor)
             {
                 const glm::vec3 offset_to_face = offset / 2.0f; // Face is inbetween current and neighbor.
@@ -558,3 +552,38 @@ const Model Chunk::getModel() const
 
     return Model(vertices, indices);
 }
+
+void Chunk::updateMesh()
+{
+    mesh = getModel();
+
+    meshBounds.reset();
+    const auto& vertices = mesh.getVertices();
+    if (!vertices.empty())
+    {
+        glm::vec3 min_bounds = vertices[0].pos;
+        glm::vec3 max_bounds = vertices[0].pos;
+        for (const auto& vertex : vertices)
+        {
+            min_bounds = glm::min(min_bounds, vertex.pos);
+            max_bounds = glm::max(max_bounds, vertex.pos);
+        }
+        meshBounds.emplace(min_bounds, max_bounds);
+    }
+}
+
+void Chunk::releaseMesh()
+{
+    mesh = Model();
+    meshBounds.reset();
+}
+
+const Model& Chunk::getMesh() const
+{
+    return mesh;
+}
+
+const std::optional<Aabb3d>& Chunk::getMeshBounds() const
+{
+    return meshBounds;
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "block.hpp"
+#include "engine/memory-tracking.hpp"
+#include "engine/physics/shapes/aabb.hpp"
 #include "engine/physics/ray/ray.hpp"
 #include "engine/renderer/model.hpp"
 
@@ -8,6 +10,7 @@
 #include "engine/usage/glm-usage.hpp"
 #include <glm/gtx/hash.hpp>
 
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <string>
@@ -29,7 +32,22 @@ using ChunkCenter = glm::vec3;
 
 class Chunk
 {
+  public:
+    // Stages a chunk goes through before it can be drawn, in order.
+    enum class State : uint8_t
+    {
+        GENERATED,       // Blocks are generated and the chunk is linked to its loaded neighbors.
+        NEIGHBORS_READY, // All 6 neighbors exist and a mesh is being built.
+        MESHED,          // The mesh is built and can be uploaded.
+        UPLOADED,        // The mesh is uploaded to the renderer.
+    };
+
+    // Bump whenever generation would produce different blocks for the same seed; invalidates cached chunks.
+    static constexpr uint32_t GENERATOR_VERSION = 1;
+
   private:
+    friend class ChunkCache; // Saves and restores generated blocks.
+
     static constexpr glm::vec3 COLOR_DEFAULT{1.0f};
     static constexpr glm::vec3 COLOR_RED{1.0f, 0.0f, 0.0f};
     static constexpr glm::vec3 COLOR_GRASS{0.349f, 0.651f, 0.290f};
@@ -60,12 +78,17 @@ class Chunk
         {BlockType::SAND,    std::make_shared<Block>(COLOR_SAND)   },
     };
 
-  public:
-    std::array<Chunk*, 6> neighboringChunks{}; // Order: +x, +y, +z, -x, -y, -z.
+    // Neighbors are linked by worker threads while other threads read them; order: +x, +y, +z, -x, -y, -z.
+    std::array<std::atomic<Chunk*>, 6> neighboringChunks{};
 
-  private:
     ChunkCenter center;
     int size;
+
+    std::atomic<State> state = State::GENERATED;
+    // Only valid once the chunk is `MESHED`. Kept while the chunk is within the render distance so that it can be
+    // uploaded again after being culled without being remeshed, and released once it leaves it.
+    Model mesh;
+    std::optional<Aabb3d> meshBounds; // Tight bounds of `mesh`; empty if the mesh is.
     int blockCount = 0; // Includes edge blocks.
 
     // Bounds are inclusive and do not include edge blocks.
@@ -73,11 +96,16 @@ class Chunk
     glm::vec3 maxBounds;
 
     // Contains blocks in this chunk.
-    using BlockContainer = std::vector<BlockType>;
+    using BlockContainer = std::vector<BlockType, TrackedAllocator<BlockType, MemoryTag::CHUNK_BLOCKS>>;
     std::unique_ptr<BlockContainer> blocks;
 
     // Stores an index into `blocks`.
-    std::unordered_set<glm::vec3> visibleBlocks;
+    using VisibleBlockSet = std::unordered_set<
+        glm::vec3,
+        std::hash<glm::vec3>,
+        std::equal_to<glm::vec3>,
+        TrackedAllocator<glm::vec3, MemoryTag::CHUNK_VISIBLE_BLOCKS>>;
+    VisibleBlockSet visibleBlocks;
 
     void initContainer();
 
@@ -94,29 +122,38 @@ class Chunk
     bool generateBlock(const glm::vec3& global_pos, const BlockType type);
     bool resetBlock(const glm::vec3& global_pos);
 
-    bool isBlockPresent(const glm::vec3& global_pos) const;
     bool isBlockVisible(const glm::vec3& global_pos) const;
     bool isBlockHidden(const glm::vec3& global_pos) const;
-    bool isBlockHidden(const glm::vec3& global_pos, const std::unordered_set<glm::vec3>& neighboring_blocks) const;
+    bool isBlockHidden(const glm::vec3& global_pos, const VisibleBlockSet& neighboring_blocks) const;
     bool isInChunkBounds(const glm::vec3& block_pos) const;
 
+    Chunk(const FastNoiseLite& height_noise, const glm::vec3& center_pos, const int size, const bool should_generate);
+
   public:
     Chunk(const FastNoiseLite& height_noise, const glm::vec3& center_pos, const int size);
 
     void addBlock(const glm::vec3& global_pos);
     void removeBlock(const glm::vec3& global_pos);
 
+    Chunk* getNeighboringChunk(const Axis axis) const;
+    void setNeighboringChunk(const Axis axis, Chunk* chunk);
+
+    bool isBlockPresent(const glm::vec3& global_pos) const;
     bool isBlockOnEdge(const glm::vec3& global_pos, const Axis axis) const;
     bool isBlockOnEdge(const glm::vec3& global_pos) const;
 
-    const std::optional<glm::vec3> getReachableBlock(const Ray& ray, glm::ivec3* face_entered = nullptr) const;
-    bool doesEntityIntersect(
-        const glm::vec3& velocity,
-        const float delta,
-        const Aabb3d& hitbox,
-        float& new_delta,
-        glm::vec3* normal = nullptr) const;
+    bool hasAllNeighboringChunks() const;
+
+    State getState() const;
+    void setState(const State new_state);
+    bool advanceState(const State expected_state, const State new_state);
 
     ChunkCenter getCenter() const;
     const Model getModel() const;
+    uint64_t getBlocksHash() const; // Of the center and every block; equal for chunks with the same contents.
+
+    void updateMesh();
+    void releaseMesh();
+    const Model& getMesh() const;
+    const std::optional<Aabb3d>& getMeshBounds() const;
 };
@@ -1,5 +1,6 @@
 #include "camera.hpp"
 
+#include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/string_cast.hpp>
 
@@ -15,7 +16,7 @@ Camera::Camera(
     : window(window), eye(eye_world), worldUp(up_world), forward(glm::normalize(target_world - eye_world)),
       right(glm::normalize(glm::cross(forward, worldUp))), up(glm::normalize(glm::cross(right, forward))), fovY(fov_y),
       aspect(aspect), zNear(z_near), zFar(z_far), eulerAngles(glm::vec3(0.0f)),
-      frustum(eye_world, forward, up, right, z_near, z_far, aspect, fov_y)
+      frustum(viewProjMatrix())
 {
     window.addResizeCallback([this]() { this->updateAspectRatio(); });
 
@@ -26,17 +27,47 @@ Camera::Camera(
     // eulerAngles = glm::vec3(pitch, yaw, roll);
 }
 
+void Camera::markDirty()
+{
+    areMatricesDirty = true;
+    isFrustumDirty = true;
+    ++version;
+}
+
+const Camera::Matrices& Camera::getMatrices() const
+{
+    if (areMatricesDirty)
+    {
+        matrices.view = glm::lookAt(eye, eye + forward, up);
+        matrices.proj = glm::perspective(fovY, aspect, zNear, zFar);
+        matrices.viewProj = matrices.proj * matrices.view;
+        matrices.inverseView = glm::affineInverse(matrices.view); // Only rotates and translates.
+        matrices.inverseProj = glm::inverse(matrices.proj);
+        matrices.inverseViewProj = matrices.inverseView * matrices.inverseProj;
+        areMatricesDirty = false;
+    }
+    return matrices;
+}
+
 void Camera::updateAspectRatio()
 {
     int width = 0, height = 0;
     window.getFrameBufferSize(width, height);
+
+    // The framebuffer is empty while the window is minimized; keep the last aspect ratio.
+    if (width == 0 || height == 0)
+    {
+        return;
+    }
+
     aspect = static_cast<float>(width) / static_cast<float>(height);
+    markDirty();
 }
 
 void Camera::translate(const glm::vec3 units)
 {
     eye += units;
-    frustum.translate(units);
+    markDirty();
 }
 
 void Camera::rotate(const float pitch, const float yaw, const float roll, const bool constrain_x_axis)
@@ -58,10 +89,7 @@ void Camera::rotate(const float pitch, const float yaw, const float roll, const
     right = glm::normalize(glm::cross(forward, worldUp));
     up = glm::normalize(glm::cross(right, forward));
 
-    // Update the frustum.
-    // TODO: currently, creating a new frustum each time; maybe should add a rotation method,
-    // or maybe handle it after implementing a scene graph.
-    frustum = Frustum(eye, forward, up, right, zNear, zFar, aspect, fovY);
+    markDirty();
 }
 
 void Camera::moveForward(const float units)
@@ -171,15 +199,45 @@ float Camera::getFar() const
 
 const Frustum& Camera::getFrustum() const
 {
+    if (isFrustumDirty)
+    {
+        frustum = Frustum(viewProjMatrix());
+        isFrustumDirty = false;
+    }
     return frustum;
 }
 
-glm::mat4 Camera::viewMatrix() const
+uint64_t Camera::getVersion() const
+{
+    return version;
+}
+
+const glm::mat4& Camera::viewMatrix() const
+{
+    return getMatrices().view;
+}
+
+const glm::mat4& Camera::projMatrix() const
+{
+    return getMatrices().proj;
+}
+
+const glm::mat4& Camera::viewProjMatrix() const
+{
+    return getMatrices().viewProj;
+}
+
+const glm::mat4& Camera::inverseViewMatrix() const
+{
+    return getMatrices().inverseView;
+}
+
+const glm::mat4& Camera::inverseProjMatrix() const
 {
-    return glm::lookAt(eye, eye + forward, up);
+    return getMatrices().inverseProj;
 }
 
-glm::mat4 Camera::projMatrix() const
+const glm::mat4& Camera::inverseViewProjMatrix() const
 {
-    return glm::perspective(fovY, aspect, zNear, zFar);
+    return getMatrices().inverseViewProj;
 }
@@ -4,6 +4,8 @@
 #include "renderer/window.hpp"
 #include "usage/glm-usage.hpp"
 
+#include <cstdint>
+
 class Camera
 {
   private:
@@ -25,7 +27,26 @@ class Camera
     float minXAngleRad = glm::radians(-89.0f);
     float maxXAngleRad = glm::radians(89.0f);
 
-    Frustum frustum;
+    // The matrices and the frustum are recomputed the first time they are needed after anything they depend on changed,
+    // so they are built at most once per frame no matter how many times the camera moves. `version` is bumped on every
+    // change so that consumers can skip their own work when nothing moved.
+    struct Matrices
+    {
+        glm::mat4 view;
+        glm::mat4 proj;
+        glm::mat4 viewProj;
+        glm::mat4 inverseView;
+        glm::mat4 inverseProj;
+        glm::mat4 inverseViewProj;
+    };
+    mutable Matrices matrices;
+    mutable bool areMatricesDirty = true;
+    mutable Frustum frustum;
+    mutable bool isFrustumDirty = false;
+    uint64_t version = 0;
+
+    void markDirty();
+    const Matrices& getMatrices() const;
 
     void updateAspectRatio();
 
@@ -69,7 +90,12 @@ class Camera
     float getNear() const;
     float getFar() const;
     const Frustum& getFrustum() const;
+    uint64_t getVersion() const;
 
-    glm::mat4 viewMatrix() const;
-    glm::mat4 projMatrix() const;
+    const glm::mat4& viewMatrix() const;
+    const glm::mat4& projMatrix() const;
+    const glm::mat4& viewProjMatrix() const; // `proj * view`.
+    const glm::mat4& inverseViewMatrix() const;
+    const glm::mat4& inverseProjMatrix() const;
+    const glm::mat4& inverseViewProjMatrix() const;
 };
@@ -0,0 +1,67 @@
+#include "fixed-timestep.hpp"
+
+#include <cassert>
+#include <cmath>
+
+void FixedTimestep::runTickCallbacks()
+{
+    const float dt = getTickDelta();
+    for (const auto& callback : tickCallbacks)
+    {
+        callback(dt);
+    }
+}
+
+FixedTimestep::FixedTimestep(const double ticks_per_second, const unsigned max_ticks_per_frame)
+    : tickDelta(1.0 / ticks_per_second), maxTicksPerFrame(max_ticks_per_frame)
+{
+    assert(ticks_per_second > 0.0);
+    assert(max_ticks_per_frame > 0);
+}
+
+unsigned FixedTimestep::advance(const double frame_delta)
+{
+    accumulator += frame_delta;
+
+    unsigned num_ticks = 0;
+    while (accumulator >= tickDelta && num_ticks < maxTicksPerFrame)
+    {
+        runTickCallbacks();
+        accumulator -= tickDelta;
+        ++tickCount;
+        ++num_ticks;
+    }
+
+    // Drop the time that couldn't be caught up on; the simulation runs slower instead of falling further behind.
+    if (accumulator >= tickDelta)
+    {
+        accumulator = std::fmod(accumulator, tickDelta);
+    }
+
+    return num_ticks;
+}
+
+void FixedTimestep::addTickCallback(const std::function<void(const float)>& callback)
+{
+    tickCallbacks.push_back(callback);
+}
+
+void FixedTimestep::clearTickCallbacks()
+{
+    tickCallbacks.clear();
+}
+
+float FixedTimestep::getTickDelta() const
+{
+    return static_cast<float>(tickDelta);
+}
+
+float FixedTimestep::getAlpha() const
+{
+    return static_cast<float>(accumulator / tickDelta);
+}
+
+uint64_t FixedTimestep::getTickCount() const
+{
+    return tickCount;
+}
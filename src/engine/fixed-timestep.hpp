@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Runs simulation ticks at a fixed rate regardless of the frame rate.
+// Frame time is accumulated and consumed in whole ticks; the fraction of a tick that is left over is exposed as an
+// interpolation factor so that rendering can blend between the last two simulated states.
+class FixedTimestep
+{
+  private:
+    double tickDelta;          // In seconds.
+    unsigned maxTicksPerFrame; // Limits catch-up after a hitch so a slow frame can't cause even slower frames.
+    double accumulator = 0.0;
+    uint64_t tickCount = 0;
+
+    std::vector<std::function<void(const float)>> tickCallbacks;
+
+    void runTickCallbacks();
+
+  public:
+    FixedTimestep(const double ticks_per_second, const unsigned max_ticks_per_frame);
+
+    unsigned advance(const double frame_delta);
+
+    void addTickCallback(const std::function<void(const float)>& callback);
+    void clearTickCallbacks();
+
+    float getTickDelta() const;
+    float getAlpha() const;
+    uint64_t getTickCount() const;
+};
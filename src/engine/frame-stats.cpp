@@ -0,0 +1,153 @@
+#include "frame-stats.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+
+// 0.5 ms to ~1.3 s in steps of 10%, so percentiles are within 10% of the actual frame time.
+const std::vector<double> FRAME_TIME_BOUNDS = VmcMetrics::Histogram::makeExponentialBounds(0.5, 1.1, 83);
+
+VmcMetrics::Histogram& frame_time_histogram = VmcMetrics::getHistogram("frame_time_ms", FRAME_TIME_BOUNDS);
+VmcMetrics::Counter& hitches_counter = VmcMetrics::getCounter("hitches");
+
+double toMilliseconds(const std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+} // namespace
+
+FrameStats::ScopedPhase::ScopedPhase(FrameStats& stats, const Phase phase)
+    : stats(stats), phase(phase), startTime(std::chrono::steady_clock::now())
+{
+}
+
+FrameStats::ScopedPhase::~ScopedPhase()
+{
+    stats.addPhaseTime(phase, std::chrono::steady_clock::now() - startTime);
+}
+
+FrameStats::ChunkWork FrameStats::getChunkWork()
+{
+    static VmcMetrics::Counter& generated = VmcMetrics::getCounter("chunks_generated");
+    static VmcMetrics::Counter& meshed = VmcMetrics::getCounter("chunks_meshed");
+    static VmcMetrics::Counter& remeshed = VmcMetrics::getCounter("remesh_processed");
+    static VmcMetrics::Counter& uploaded = VmcMetrics::getCounter("chunks_uploaded");
+    static VmcMetrics::Counter& upload_bytes = VmcMetrics::getCounter("upload_bytes");
+
+    return {generated.get(), meshed.get(), remeshed.get(), uploaded.get(), upload_bytes.get()};
+}
+
+void FrameStats::logHitch(const double frame_time) const
+{
+    const ChunkWork work = getChunkWork();
+
+    std::ostringstream message;
+    message << std::fixed << std::setprecision(1);
+    message << "\nHitch: " << frame_time << " ms (";
+    for (size_t i = 0; i < NUM_PHASES; ++i)
+    {
+        message << ((i > 0) ? ", " : "") << getPhaseName(static_cast<Phase>(i)) << " "
+                << toMilliseconds(phaseTimes[i]);
+    }
+    message << "); chunks generated " << (work.generated - chunkWorkAtFrameStart.generated) << ", meshed "
+            << (work.meshed - chunkWorkAtFrameStart.meshed) << ", remeshed "
+            << (work.remeshed - chunkWorkAtFrameStart.remeshed) << ", uploaded "
+            << (work.uploaded - chunkWorkAtFrameStart.uploaded) << " ("
+            << ((work.uploadBytes - chunkWorkAtFrameStart.uploadBytes) / 1024) << " KiB)";
+
+    std::cout << message.str() << std::endl;
+}
+
+FrameStats::FrameStats(const std::chrono::duration<double, std::milli> hitch_threshold)
+    : hitchThreshold(hitch_threshold), currentSlice(FRAME_TIME_BOUNDS), sliceStartTime(std::chrono::steady_clock::now())
+{
+}
+
+const char* FrameStats::getPhaseName(const Phase phase)
+{
+    switch (phase)
+    {
+    case Phase::INPUT: {
+        return "input";
+    }
+    case Phase::PLAYER_UPDATE: {
+        return "player update";
+    }
+    case Phase::WORLD_DRAW: {
+        return "world draw";
+    }
+    case Phase::RECORD: {
+        return "record";
+    }
+    case Phase::SUBMIT: {
+        return "submit";
+    }
+    case Phase::PRESENT_WAIT: {
+        return "present wait";
+    }
+    case Phase::COUNT: {
+        break;
+    }
+    }
+    return "unknown";
+}
+
+void FrameStats::beginFrame()
+{
+    frameStartTime = std::chrono::steady_clock::now();
+    phaseTimes.fill(std::chrono::nanoseconds(0));
+    chunkWorkAtFrameStart = getChunkWork();
+}
+
+void FrameStats::addPhaseTime(const Phase phase, const std::chrono::nanoseconds time)
+{
+    phaseTimes[static_cast<size_t>(phase)] += time;
+}
+
+bool FrameStats::endFrame()
+{
+    const auto end_time = std::chrono::steady_clock::now();
+    const double frame_time = toMilliseconds(end_time - frameStartTime);
+
+    currentSlice.record(frame_time);
+    frame_time_histogram.record(frame_time);
+    if (frame_time > hitchThreshold.count())
+    {
+        hitches_counter.add();
+        logHitch(frame_time);
+    }
+
+    if (end_time - sliceStartTime < SLICE_DURATION)
+    {
+        return false;
+    }
+
+    sliceStartTime = end_time;
+    slices.push_back(currentSlice.takeSnapshot());
+    if (slices.size() > NUM_WINDOW_SLICES)
+    {
+        slices.pop_front();
+    }
+
+    VmcMetrics::Histogram::Snapshot window;
+    for (const auto& slice : slices)
+    {
+        window.merge(slice);
+    }
+    summary.numFrames = window.count;
+    summary.p50 = window.getPercentile(0.5);
+    summary.p95 = window.getPercentile(0.95);
+    summary.p99 = window.getPercentile(0.99);
+    summary.max = window.max;
+    return true;
+}
+
+const FrameStats::Summary& FrameStats::getSummary() const
+{
+    return summary;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "metrics.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+
+// Frame time distribution over a rolling window, split into CPU phases, with a log of hitches.
+// Frame times go into fixed buckets per one-second slice; the last few slices are merged for the percentiles, so the
+// summary reflects recent stutter instead of being averaged away like an FPS counter. A frame slower than the hitch
+// threshold is logged with its phase times and the chunk work that happened during it.
+class FrameStats
+{
+  public:
+    enum class Phase : uint8_t
+    {
+        INPUT,
+        PLAYER_UPDATE,
+        WORLD_DRAW,
+        RECORD,
+        SUBMIT,
+        PRESENT_WAIT,
+        COUNT,
+    };
+
+    // In milliseconds.
+    struct Summary
+    {
+        uint64_t numFrames = 0;
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    // Adds the time from its construction to its destruction to a phase of the current frame.
+    class ScopedPhase
+    {
+      private:
+        FrameStats& stats;
+        Phase phase;
+        std::chrono::steady_clock::time_point startTime;
+
+      public:
+        ScopedPhase(FrameStats& stats, const Phase phase);
+        ScopedPhase(const ScopedPhase& other) = delete;
+        ScopedPhase(ScopedPhase&& other) = delete;
+        ~ScopedPhase();
+
+        ScopedPhase& operator=(const ScopedPhase& other) = delete;
+        ScopedPhase& operator=(ScopedPhase&& other) = delete;
+    };
+
+  private:
+    static constexpr size_t NUM_PHASES = static_cast<size_t>(Phase::COUNT);
+    static constexpr std::chrono::seconds SLICE_DURATION{1};
+    static constexpr size_t NUM_WINDOW_SLICES = 5;
+
+    // Counters of the work that can make a frame slow, so a hitch can report how much of each happened during it.
+    struct ChunkWork
+    {
+        uint64_t generated = 0;
+        uint64_t meshed = 0;
+        uint64_t remeshed = 0;
+        uint64_t uploaded = 0;
+        uint64_t uploadBytes = 0;
+    };
+
+    std::chrono::duration<double, std::milli> hitchThreshold;
+
+    std::chrono::steady_clock::time_point frameStartTime;
+    std::array<std::chrono::nanoseconds, NUM_PHASES> phaseTimes{};
+    ChunkWork chunkWorkAtFrameStart;
+
+    VmcMetrics::Histogram currentSlice;
+    std::chrono::steady_clock::time_point sliceStartTime;
+    std::deque<VmcMetrics::Histogram::Snapshot> slices; // The last `NUM_WINDOW_SLICES` complete slices; oldest first.
+    Summary summary;
+
+    static ChunkWork getChunkWork();
+
+    void logHitch(const double frame_time) const;
+
+  public:
+    explicit FrameStats(const std::chrono::duration<double, std::milli> hitch_threshold);
+
+    static const char* getPhaseName(const Phase phase);
+
+    void beginFrame();
+    void addPhaseTime(const Phase phase, const std::chrono::nanoseconds time);
+    bool endFrame(); // Returns true if a slice ended, i.e. the summary was updated.
+
+    const Summary& getSummary() const;
+};
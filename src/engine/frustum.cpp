@@ -1,51 +1,239 @@
 #include "frustum.hpp"
 
-#include "physics/collision-handler.hpp"
-
-#include <glm/gtx/string_cast.hpp>
-
-#include <iostream>
-
-Frustum::Frustum(
-    const glm::vec3& origin,
-    const glm::vec3& forward,
-    const glm::vec3& up,
-    const glm::vec3& right,
-    const float z_near,
-    const float z_far,
-    const float aspect,
-    const float fov_y)
-{
-    const float half_y = z_far * std::tan(fov_y * 0.5f);
-    const float half_x = half_y * aspect;
-    const glm::vec3 near_vec = z_near * forward;
-    const glm::vec3 far_vec = z_far * forward;
-
-    // Normals will point towards the frustum volume.
-    nearPlane = Plane3d(forward, origin + near_vec);
-    farPlane = Plane3d(-forward, origin + far_vec);
-    topPlane = Plane3d(glm::cross(far_vec + up * half_y, right), origin);
-    bottomPlane = Plane3d(glm::cross(right, far_vec - up * half_y), origin);
-    leftPlane = Plane3d(glm::cross(far_vec - right * half_x, up), origin);
-    rightPlane = Plane3d(glm::cross(up, far_vec + right * half_x), origin);
+#include "physics/simd-lanes.hpp"
+
+#include <glm/gtc/matrix_access.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+using VmcSimd::ScalarLanes;
+using VmcSimd::SimdLanes;
+
+// Same as `CollisionHandler::aabbToPlaneIntersect` (above the surface) for `Lanes::WIDTH` boxes; the additions are
+// done in the same order so that the results match.
+template <typename Lanes>
+typename Lanes::Mask isAabbAbovePlaneLanes(
+    const typename Lanes::Float centers[3],
+    const typename Lanes::Float extents[3],
+    const typename Lanes::Float normal[3],
+    const typename Lanes::Float abs_normal[3],
+    const typename Lanes::Float distance)
+{
+    using Float = typename Lanes::Float;
+
+    const Float radius = Lanes::add(
+        Lanes::add(Lanes::mul(extents[0], abs_normal[0]), Lanes::mul(extents[1], abs_normal[1])),
+        Lanes::mul(extents[2], abs_normal[2]));
+    const Float dot = Lanes::add(
+        Lanes::add(Lanes::mul(normal[0], centers[0]), Lanes::mul(normal[1], centers[1])),
+        Lanes::mul(normal[2], centers[2]));
+    const Float dist_center_to_plane = Lanes::sub(dot, distance);
+
+    return Lanes::lessEqual(Lanes::sub(Lanes::set(0.0f), radius), dist_center_to_plane);
+}
+} // namespace
+
+// `plane` is (a, b, c, d) for the plane `ax + by + cz + d = 0`.
+void Frustum::setPlane(const size_t index, const glm::vec4& plane)
+{
+    const float inv_length = 1.0f / glm::length(glm::vec3(plane));
+    for (glm::length_t axis = 0; axis < 3; ++axis)
+    {
+        normals[axis][index] = plane[axis] * inv_length;
+        absNormals[axis][index] = std::abs(normals[axis][index]);
+    }
+    distances[index] = -plane.w * inv_length;
+}
+
+// Visibility bits of `Lanes::WIDTH` boxes starting at `first`.
+template <typename Lanes>
+unsigned Frustum::cullAabbsLanes(const Aabb3dBatch& aabbs, const size_t first, uint8_t* plane_hints) const
+{
+    using Float = typename Lanes::Float;
+
+    const Float half = Lanes::set(0.5f);
+    Float centers[3];
+    Float extents[3];
+    for (glm::length_t axis = 0; axis < 3; ++axis)
+    {
+        const Float min_bounds = Lanes::load(aabbs.getMinBounds(axis) + first);
+        const Float max_bounds = Lanes::load(aabbs.getMaxBounds(axis) + first);
+        centers[axis] = Lanes::mul(Lanes::add(max_bounds, min_bounds), half);
+        extents[axis] = Lanes::mul(Lanes::sub(max_bounds, min_bounds), half);
+    }
+
+    if (plane_hints != nullptr)
+    {
+        // Neighboring boxes are usually rejected by the same plane, in which case the plane is broadcast instead of
+        // gathered.
+        const uint8_t* hints = plane_hints + first;
+        const bool same_hint = std::all_of(hints, hints + Lanes::WIDTH, [&](const uint8_t h) { return h == hints[0]; });
+        const auto load_plane = [&](const float* values)
+        { return same_hint ? Lanes::set(values[hints[0]]) : Lanes::loadIndexed(values, hints); };
+
+        const Float normal[3] = {
+            load_plane(normals[0].data()),
+            load_plane(normals[1].data()),
+            load_plane(normals[2].data())};
+        const Float abs_normal[3] = {
+            load_plane(absNormals[0].data()),
+            load_plane(absNormals[1].data()),
+            load_plane(absNormals[2].data())};
+        const Float distance = load_plane(distances.data());
+
+        if (Lanes::toBits(isAabbAbovePlaneLanes<Lanes>(centers, extents, normal, abs_normal, distance)) == 0)
+        {
+            return 0;
+        }
+    }
+
+    const unsigned all_lanes = (1u << Lanes::WIDTH) - 1;
+    unsigned visible = all_lanes;
+    std::array<unsigned, NUM_PLANES> rejected{};
+    for (size_t i = 0; i < NUM_PLANES && visible != 0; ++i)
+    {
+        const Float normal[3] = {Lanes::set(normals[0][i]), Lanes::set(normals[1][i]), Lanes::set(normals[2][i])};
+        const Float abs_normal[3] = {
+            Lanes::set(absNormals[0][i]),
+            Lanes::set(absNormals[1][i]),
+            Lanes::set(absNormals[2][i])};
+        const unsigned above = Lanes::toBits(
+            isAabbAbovePlaneLanes<Lanes>(centers, extents, normal, abs_normal, Lanes::set(distances[i])));
+
+        rejected[i] = visible & ~above;
+        visible &= above;
+    }
+
+    if (plane_hints != nullptr && visible != all_lanes)
+    {
+        for (size_t lane = 0; lane < Lanes::WIDTH; ++lane)
+        {
+            for (size_t i = 0; i < NUM_PLANES; ++i)
+            {
+                if ((rejected[i] >> lane) & 1u)
+                {
+                    plane_hints[first + lane] = static_cast<uint8_t>(i);
+                    break;
+                }
+            }
+        }
+    }
+
+    return visible;
+}
+
+Frustum::Frustum(const glm::mat4& view_proj)
+{
+    // Gribb-Hartmann: a point is inside if its clip coordinates satisfy -w <= x <= w, -w <= y <= w and near <= z <= w,
+    // and each of those inequalities is a plane made from rows of the matrix. Normals will point towards the frustum
+    // volume. Flipping the y-axis of the projection only swaps the top and bottom planes.
+    const glm::vec4 row_x = glm::row(view_proj, 0);
+    const glm::vec4 row_y = glm::row(view_proj, 1);
+    const glm::vec4 row_z = glm::row(view_proj, 2);
+    const glm::vec4 row_w = glm::row(view_proj, 3);
+
+#if GLM_CONFIG_CLIP_CONTROL & GLM_CLIP_CONTROL_ZO_BIT
+    setPlane(0, row_z); // Near; depth is in [0, 1].
+#else
+    setPlane(0, row_w + row_z); // Near; depth is in [-1, 1].
+#endif
+    setPlane(1, row_w - row_z); // Far.
+    setPlane(2, row_w - row_y); // Top.
+    setPlane(3, row_w + row_y); // Bottom.
+    setPlane(4, row_w + row_x); // Left.
+    setPlane(5, row_w - row_x); // Right.
 }
 
 bool Frustum::isAabbInside(const Aabb3d& aabb) const
 {
-    return CollisionHandler::aabbToPlaneIntersect(aabb, nearPlane, true) &&
-           CollisionHandler::aabbToPlaneIntersect(aabb, farPlane, true) &&
-           CollisionHandler::aabbToPlaneIntersect(aabb, topPlane, true) &&
-           CollisionHandler::aabbToPlaneIntersect(aabb, bottomPlane, true) &&
-           CollisionHandler::aabbToPlaneIntersect(aabb, leftPlane, true) &&
-           CollisionHandler::aabbToPlaneIntersect(aabb, rightPlane, true);
+    const glm::vec3 center = aabb.getCenter();
+    const glm::vec3 extents = aabb.getLength();
+    const float centers_lanes[3] = {center.x, center.y, center.z};
+    const float extents_lanes[3] = {extents.x, extents.y, extents.z};
+
+    for (size_t i = 0; i < NUM_PLANES; ++i)
+    {
+        const float normal[3] = {normals[0][i], normals[1][i], normals[2][i]};
+        const float abs_normal[3] = {absNormals[0][i], absNormals[1][i], absNormals[2][i]};
+        if (!isAabbAbovePlaneLanes<ScalarLanes>(centers_lanes, extents_lanes, normal, abs_normal, distances[i]))
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
-void Frustum::translate(const glm::vec3& units)
+Frustum::Intersection Frustum::classifyAabb(const Aabb3d& aabb, uint8_t* plane_hint) const
 {
-    nearPlane.translate(units);
-    farPlane.translate(units);
-    topPlane.translate(units);
-    bottomPlane.translate(units);
-    leftPlane.translate(units);
-    rightPlane.translate(units);
+    const glm::vec3 center = aabb.getCenter();
+    const glm::vec3 extents = aabb.getLength();
+
+    const auto get_dist_and_radius = [&](const size_t i) {
+        const float radius = extents.x * absNormals[0][i] + extents.y * absNormals[1][i] + extents.z * absNormals[2][i];
+        const float dist_center_to_plane =
+            normals[0][i] * center.x + normals[1][i] * center.y + normals[2][i] * center.z - distances[i];
+        return std::make_pair(dist_center_to_plane, radius);
+    };
+
+    if (plane_hint != nullptr)
+    {
+        const auto [dist, radius] = get_dist_and_radius(*plane_hint);
+        if (dist < -radius)
+        {
+            return Intersection::OUTSIDE;
+        }
+    }
+
+    Intersection result = Intersection::INSIDE;
+    for (size_t i = 0; i < NUM_PLANES; ++i)
+    {
+        const auto [dist, radius] = get_dist_and_radius(i);
+        if (dist < -radius)
+        {
+            if (plane_hint != nullptr)
+            {
+                *plane_hint = static_cast<uint8_t>(i);
+            }
+            return Intersection::OUTSIDE;
+        }
+        if (dist < radius)
+        {
+            result = Intersection::INTERSECTING;
+        }
+    }
+    return result;
+}
+
+void Frustum::cullAabbs(
+    const Aabb3dBatch& aabbs,
+    std::vector<uint64_t>& out_visible,
+    std::vector<uint8_t>* plane_hints) const
+{
+    const size_t num_aabbs = aabbs.size();
+    out_visible.assign((num_aabbs + 63) / 64, 0);
+
+    uint8_t* hints = nullptr;
+    if (plane_hints != nullptr)
+    {
+        if (plane_hints->size() != num_aabbs)
+        {
+            plane_hints->assign(num_aabbs, 0);
+        }
+        hints = plane_hints->data();
+    }
+
+    // The lane width divides 64, so a group of lanes never straddles two words.
+    size_t i = 0;
+    for (; i + SimdLanes::WIDTH <= num_aabbs; i += SimdLanes::WIDTH)
+    {
+        out_visible[i / 64] |= static_cast<uint64_t>(cullAabbsLanes<SimdLanes>(aabbs, i, hints)) << (i % 64);
+    }
+    for (; i < num_aabbs; ++i)
+    {
+        out_visible[i / 64] |= static_cast<uint64_t>(cullAabbsLanes<ScalarLanes>(aabbs, i, hints)) << (i % 64);
+    }
 }
@@ -1,29 +1,52 @@
 #pragma once
 
+#include "physics/shapes/aabb-batch.hpp"
 #include "physics/shapes/aabb.hpp"
-#include "physics/shapes/plane.hpp"
 
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// The planes are extracted from a view-projection matrix, so the frustum is exactly the volume that is rendered with
+// it. They are stored as structure-of-arrays (one array per normal axis) so that a batch of AABBs can be tested against
+// a plane with a handful of vector instructions.
 class Frustum
 {
+  public:
+    static constexpr size_t NUM_PLANES = 6;
+
+    enum class Intersection : uint8_t
+    {
+        OUTSIDE,
+        INTERSECTING,
+        INSIDE,
+    };
+
   private:
-    Plane3d nearPlane;
-    Plane3d farPlane;
-    Plane3d topPlane;
-    Plane3d bottomPlane;
-    Plane3d leftPlane;
-    Plane3d rightPlane;
+    // Indexed by axis then plane; normals point towards the frustum volume.
+    std::array<std::array<float, NUM_PLANES>, 3> normals;
+    std::array<std::array<float, NUM_PLANES>, 3> absNormals;
+    std::array<float, NUM_PLANES> distances;
+
+    void setPlane(const size_t index, const glm::vec4& plane);
+
+    template <typename Lanes>
+    unsigned cullAabbsLanes(const Aabb3dBatch& aabbs, const size_t first, uint8_t* plane_hints) const;
 
   public:
-    Frustum(
-        const glm::vec3& origin,
-        const glm::vec3& forward,
-        const glm::vec3& up,
-        const glm::vec3& right,
-        const float z_near,
-        const float z_far,
-        const float aspect,
-        const float fov_y);
+    explicit Frustum(const glm::mat4& view_proj); // `proj * view`.
 
     bool isAabbInside(const Aabb3d& aabb) const;
-    void translate(const glm::vec3& units);
+
+    // Like `isAabbInside` but also tells whether the box is entirely inside, so that everything in it can be accepted
+    // without further tests. `plane_hint` works like in `cullAabbs`.
+    Intersection classifyAabb(const Aabb3d& aabb, uint8_t* plane_hint = nullptr) const;
+
+    // Sets bit `i % 64` of `out_visible[i / 64]` if box `i` is at least partly inside, like `isAabbInside`.
+    // If given, `plane_hints` holds the plane that last rejected each box; it is tested first since it most likely
+    // rejects the box again, and is reset if its size doesn't match.
+    void cullAabbs(
+        const Aabb3dBatch& aabbs,
+        std::vector<uint64_t>& out_visible,
+        std::vector<uint8_t>* plane_hints = nullptr) const;
 };
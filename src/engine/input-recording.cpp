@@ -0,0 +1,105 @@
+#include "input-recording.hpp"
+
+#include <array>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+
+constexpr std::array<char, 8> MAGIC = {'V', 'M', 'C', 'I', 'N', 'P', 'U', 'T'};
+constexpr uint32_t VERSION = 1;
+
+template <typename T>
+void writeValue(std::ofstream& file, const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool readValue(std::ifstream& file, T& value)
+{
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+} // namespace
+
+InputRecorder::InputRecorder(const std::filesystem::path& path, const InputRecordingHeader& header)
+    : file(path, std::ios::binary | std::ios::trunc)
+{
+    if (!file)
+    {
+        throw std::runtime_error("failed to open input recording " + path.string() + "!");
+    }
+
+    writeValue(file, MAGIC);
+    writeValue(file, VERSION);
+    writeValue(file, header.worldSeed);
+    writeValue(file, header.ticksPerSecond);
+}
+
+void InputRecorder::record(const InputState& state)
+{
+    // Field by field so the layout doesn't depend on padding.
+    writeValue(file, state.keysDown);
+    writeValue(file, state.keysPressed);
+    writeValue(file, state.mouseButtonsDown);
+    writeValue(file, static_cast<uint8_t>(state.isCursorDisabled));
+    writeValue(file, state.cursorX);
+    writeValue(file, state.cursorY);
+    ++numTicks;
+}
+
+uint64_t InputRecorder::getNumTicks() const
+{
+    return numTicks;
+}
+
+InputReplay::InputReplay(const std::filesystem::path& path) : file(path, std::ios::binary)
+{
+    if (!file)
+    {
+        throw std::runtime_error("failed to open input recording " + path.string() + "!");
+    }
+
+    std::array<char, 8> magic{};
+    uint32_t version = 0;
+    if (!readValue(file, magic) || magic != MAGIC || !readValue(file, version))
+    {
+        throw std::runtime_error(path.string() + " is not an input recording!");
+    }
+    if (version != VERSION)
+    {
+        throw std::runtime_error("unsupported input recording version " + std::to_string(version) + "!");
+    }
+    if (!readValue(file, header.worldSeed) || !readValue(file, header.ticksPerSecond))
+    {
+        throw std::runtime_error("input recording " + path.string() + " is truncated!");
+    }
+}
+
+std::optional<InputState> InputReplay::next()
+{
+    InputState state;
+    uint8_t is_cursor_disabled = 0;
+    if (!readValue(file, state.keysDown) || !readValue(file, state.keysPressed) ||
+        !readValue(file, state.mouseButtonsDown) || !readValue(file, is_cursor_disabled) ||
+        !readValue(file, state.cursorX) || !readValue(file, state.cursorY))
+    {
+        return std::nullopt; // A partly written last record (e.g. the game was killed) is dropped.
+    }
+    state.isCursorDisabled = (is_cursor_disabled != 0);
+
+    ++numTicks;
+    return state;
+}
+
+const InputRecordingHeader& InputReplay::getHeader() const
+{
+    return header;
+}
+
+uint64_t InputReplay::getNumTicks() const
+{
+    return numTicks;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "input.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+
+// Input recordings hold the `InputState` of every simulation tick of a session, so that replaying them with the same
+// world and tick rate reproduces the same movement, chunk requests and block edits.
+// The file is binary in native byte order: a magic string and version, the header, then one fixed-size record per tick.
+struct InputRecordingHeader
+{
+    uint32_t worldSeed = 0;
+    double ticksPerSecond = 0.0;
+};
+
+class InputRecorder
+{
+  private:
+    std::ofstream file;
+    uint64_t numTicks = 0;
+
+  public:
+    InputRecorder(const std::filesystem::path& path, const InputRecordingHeader& header);
+
+    void record(const InputState& state);
+
+    uint64_t getNumTicks() const;
+};
+
+class InputReplay
+{
+  private:
+    std::ifstream file;
+    InputRecordingHeader header;
+    uint64_t numTicks = 0;
+
+  public:
+    explicit InputReplay(const std::filesystem::path& path);
+
+    std::optional<InputState> next(); // Empty once every tick has been replayed.
+
+    const InputRecordingHeader& getHeader() const;
+    uint64_t getNumTicks() const; // Replayed so far.
+};
@@ -0,0 +1,81 @@
+#include "input.hpp"
+
+#include <algorithm>
+
+namespace
+{
+
+// -1 if the key isn't tracked.
+int getKeyIndex(const int key)
+{
+    const auto it = std::find(InputState::TRACKED_KEYS.begin(), InputState::TRACKED_KEYS.end(), key);
+    return (it != InputState::TRACKED_KEYS.end()) ? static_cast<int>(it - InputState::TRACKED_KEYS.begin()) : -1;
+}
+
+int getMouseButtonIndex(const int button)
+{
+    const auto it =
+        std::find(InputState::TRACKED_MOUSE_BUTTONS.begin(), InputState::TRACKED_MOUSE_BUTTONS.end(), button);
+    return (it != InputState::TRACKED_MOUSE_BUTTONS.end())
+               ? static_cast<int>(it - InputState::TRACKED_MOUSE_BUTTONS.begin())
+               : -1;
+}
+
+} // namespace
+
+bool InputState::isKeyDown(const int key) const
+{
+    const int index = getKeyIndex(key);
+    return (index >= 0) && ((keysDown >> index) & 1u);
+}
+
+bool InputState::wasKeyPressed(const int key) const
+{
+    const int index = getKeyIndex(key);
+    return (index >= 0) && ((keysPressed >> index) & 1u);
+}
+
+bool InputState::isMouseButtonDown(const int button) const
+{
+    const int index = getMouseButtonIndex(button);
+    return (index >= 0) && ((mouseButtonsDown >> index) & 1u);
+}
+
+InputSampler::InputSampler(Window& window) : window(window)
+{
+    window.addKeyCallback([this](const int key,
+                                 [[maybe_unused]] const int scancode,
+                                 const int action,
+                                 [[maybe_unused]] const int mods) {
+        const int index = getKeyIndex(key);
+        if (action == GLFW_PRESS && index >= 0)
+        {
+            keysPressed |= static_cast<uint16_t>(1u << index);
+        }
+    });
+}
+
+InputState InputSampler::sample()
+{
+    InputState state;
+    for (size_t i = 0; i < InputState::TRACKED_KEYS.size(); ++i)
+    {
+        if (window.getKeyboardKey(InputState::TRACKED_KEYS[i]) == GLFW_PRESS)
+        {
+            state.keysDown |= static_cast<uint16_t>(1u << i);
+        }
+    }
+    for (size_t i = 0; i < InputState::TRACKED_MOUSE_BUTTONS.size(); ++i)
+    {
+        if (window.getMouseButtonState(InputState::TRACKED_MOUSE_BUTTONS[i]) == GLFW_PRESS)
+        {
+            state.mouseButtonsDown |= static_cast<uint8_t>(1u << i);
+        }
+    }
+    state.keysPressed = keysPressed;
+    state.isCursorDisabled = (window.getInputMode(GLFW_CURSOR) == GLFW_CURSOR_DISABLED);
+    window.getCursorPosition(state.cursorX, state.cursorY);
+
+    keysPressed = 0;
+    return state;
+}
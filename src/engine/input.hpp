@@ -0,0 +1,48 @@
+#pragma once
+
+#include "renderer/window.hpp"
+
+#include <array>
+#include <cstdint>
+
+// Everything the simulation reads from the keyboard and mouse during one tick. Ticks consume this instead of polling
+// the window, so a recorded sequence of states can be fed back to reproduce a session exactly.
+struct InputState
+{
+    // GLFW keys that the simulation uses; a key's bit in `keysDown`/`keysPressed` is its index here.
+    static constexpr std::array<int, 8> TRACKED_KEYS = {
+        GLFW_KEY_W,
+        GLFW_KEY_A,
+        GLFW_KEY_S,
+        GLFW_KEY_D,
+        GLFW_KEY_SPACE,
+        GLFW_KEY_LEFT_SHIFT,
+        GLFW_KEY_LEFT_CONTROL,
+        GLFW_KEY_F1,
+    };
+    static constexpr std::array<int, 2> TRACKED_MOUSE_BUTTONS = {GLFW_MOUSE_BUTTON_LEFT, GLFW_MOUSE_BUTTON_RIGHT};
+
+    uint16_t keysDown = 0;
+    uint16_t keysPressed = 0; // Pressed since the previous tick, even if released again before it.
+    uint8_t mouseButtonsDown = 0;
+    bool isCursorDisabled = false; // Mouse movement only looks around while the cursor is disabled.
+    double cursorX = 0.0;
+    double cursorY = 0.0;
+
+    bool isKeyDown(const int key) const;
+    bool wasKeyPressed(const int key) const;
+    bool isMouseButtonDown(const int button) const;
+};
+
+// Samples the live input state of a window once per tick.
+class InputSampler
+{
+  private:
+    const Window& window;
+    uint16_t keysPressed = 0; // Since the last sample; key events arrive between ticks, so they are latched.
+
+  public:
+    explicit InputSampler(Window& window);
+
+    InputState sample();
+};
@@ -0,0 +1,98 @@
+#include "memory-tracking.hpp"
+
+#include "metrics.hpp"
+
+#include <array>
+#include <atomic>
+#include <string>
+
+namespace
+{
+
+constexpr size_t NUM_TAGS = static_cast<size_t>(MemoryTag::COUNT);
+
+// On separate cache lines since chunk workers update different tags at the same time.
+struct alignas(64) TagUsage
+{
+    std::atomic<int64_t> bytes = 0;
+    std::atomic<int64_t> numAllocations = 0;
+};
+
+std::array<TagUsage, NUM_TAGS> tag_usages;
+
+} // namespace
+
+namespace VmcMemory
+{
+
+void recordAllocation(const MemoryTag tag, const size_t num_bytes)
+{
+    TagUsage& usage = tag_usages[static_cast<size_t>(tag)];
+    usage.bytes.fetch_add(static_cast<int64_t>(num_bytes), std::memory_order_relaxed);
+    usage.numAllocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void recordDeallocation(const MemoryTag tag, const size_t num_bytes)
+{
+    TagUsage& usage = tag_usages[static_cast<size_t>(tag)];
+    usage.bytes.fetch_sub(static_cast<int64_t>(num_bytes), std::memory_order_relaxed);
+    usage.numAllocations.fetch_sub(1, std::memory_order_relaxed);
+}
+
+Usage getUsage(const MemoryTag tag)
+{
+    const TagUsage& usage = tag_usages[static_cast<size_t>(tag)];
+    return {usage.bytes.load(std::memory_order_relaxed), usage.numAllocations.load(std::memory_order_relaxed)};
+}
+
+const char* getTagName(const MemoryTag tag)
+{
+    switch (tag)
+    {
+    case MemoryTag::CHUNK_BLOCKS:
+        return "chunk_blocks";
+    case MemoryTag::CHUNK_VISIBLE_BLOCKS:
+        return "chunk_visible_blocks";
+    case MemoryTag::MESHES:
+        return "meshes";
+    case MemoryTag::DEVICE_MESH_BUFFERS:
+        return "device_mesh_buffers";
+    case MemoryTag::DEVICE_STAGING_BUFFERS:
+        return "device_staging_buffers";
+    case MemoryTag::DEVICE_UNIFORM_BUFFERS:
+        return "device_uniform_buffers";
+    case MemoryTag::DEVICE_OTHER_BUFFERS:
+        return "device_other_buffers";
+    case MemoryTag::DEVICE_TEXTURES:
+        return "device_textures";
+    default:
+        return "unknown";
+    }
+}
+
+void publishMetrics()
+{
+    struct TagGauges
+    {
+        VmcMetrics::Gauge* bytes;
+        VmcMetrics::Gauge* numAllocations;
+    };
+    static const std::array<TagGauges, NUM_TAGS> tag_gauges = [] {
+        std::array<TagGauges, NUM_TAGS> gauges{};
+        for (size_t i = 0; i < NUM_TAGS; ++i)
+        {
+            const std::string prefix = std::string("memory.") + getTagName(static_cast<MemoryTag>(i));
+            gauges[i] = {&VmcMetrics::getGauge(prefix + "_bytes"), &VmcMetrics::getGauge(prefix + "_allocations")};
+        }
+        return gauges;
+    }();
+
+    for (size_t i = 0; i < NUM_TAGS; ++i)
+    {
+        const Usage usage = getUsage(static_cast<MemoryTag>(i));
+        tag_gauges[i].bytes->set(static_cast<double>(usage.bytes));
+        tag_gauges[i].numAllocations->set(static_cast<double>(usage.numAllocations));
+    }
+}
+
+} // namespace VmcMemory
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// Bytes held by each subsystem, so memory budgets (e.g. for evicting chunks) can be based on measurements.
+// Host containers opt in by using `TrackedAllocator` with their tag; device allocations are recorded by `Buffer` and
+// `Texture` with the size VMA actually allocated. Totals are process-wide and updated with relaxed atomics, so reading
+// them while other threads allocate gives a recent value rather than an exact one.
+enum class MemoryTag : uint8_t
+{
+    CHUNK_BLOCKS,         // Block containers of chunks.
+    CHUNK_VISIBLE_BLOCKS, // Visible block sets of chunks, including hash nodes and buckets.
+    MESHES,               // Vertices and indices of models on the host, e.g. chunk meshes.
+    DEVICE_MESH_BUFFERS,  // Vertex and index buffers.
+    DEVICE_STAGING_BUFFERS,
+    DEVICE_UNIFORM_BUFFERS,
+    DEVICE_OTHER_BUFFERS,
+    DEVICE_TEXTURES,
+    COUNT,
+};
+
+namespace VmcMemory
+{
+
+struct Usage
+{
+    int64_t bytes = 0;
+    int64_t numAllocations = 0;
+};
+
+void recordAllocation(const MemoryTag tag, const size_t num_bytes);
+void recordDeallocation(const MemoryTag tag, const size_t num_bytes);
+
+Usage getUsage(const MemoryTag tag);
+const char* getTagName(const MemoryTag tag);
+
+// Sets the `memory.<tag>_bytes` and `memory.<tag>_allocations` gauges to the current usage of every tag.
+void publishMetrics();
+
+} // namespace VmcMemory
+
+// Standard allocator that records what it allocates under `Tag`; containers rebind it to their node types, so node
+// based containers are accounted for in full.
+template <typename T, MemoryTag Tag> class TrackedAllocator
+{
+  public:
+    using value_type = T;
+
+    template <typename U> struct rebind
+    {
+        using other = TrackedAllocator<U, Tag>;
+    };
+
+    TrackedAllocator() = default;
+    template <typename U> TrackedAllocator(const TrackedAllocator<U, Tag>&) noexcept
+    {
+    }
+
+    T* allocate(const size_t n)
+    {
+        T* p = static_cast<T*>(::operator new(n * sizeof(T)));
+        VmcMemory::recordAllocation(Tag, n * sizeof(T));
+        return p;
+    }
+
+    void deallocate(T* p, const size_t n) noexcept
+    {
+        VmcMemory::recordDeallocation(Tag, n * sizeof(T));
+        ::operator delete(p);
+    }
+
+    template <typename U> bool operator==(const TrackedAllocator<U, Tag>&) const noexcept
+    {
+        return true;
+    }
+};
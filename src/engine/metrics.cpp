@@ -0,0 +1,314 @@
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <map>
+#include <mutex>
+
+namespace
+{
+
+struct Registry
+{
+    std::mutex mutex;
+    std::map<std::string, std::unique_ptr<VmcMetrics::Counter>> counters;
+    std::map<std::string, std::unique_ptr<VmcMetrics::Gauge>> gauges;
+    std::map<std::string, std::unique_ptr<VmcMetrics::Histogram>> histograms;
+};
+
+// Constructed on first use so that metrics can be registered during static initialization in any translation unit.
+Registry& getRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+void updateMax(std::atomic<double>& max, const double value)
+{
+    double curr_max = max.load(std::memory_order_relaxed);
+    while (value > curr_max && !max.compare_exchange_weak(curr_max, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+double toSeconds(const std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+} // namespace
+
+namespace VmcMetrics
+{
+
+void Counter::add(const uint64_t amount)
+{
+    value.fetch_add(amount, std::memory_order_relaxed);
+}
+
+uint64_t Counter::get() const
+{
+    return value.load(std::memory_order_relaxed);
+}
+
+void Gauge::set(const double new_value)
+{
+    value.store(new_value, std::memory_order_relaxed);
+}
+
+void Gauge::add(const double amount)
+{
+    value.fetch_add(amount, std::memory_order_relaxed);
+}
+
+double Gauge::get() const
+{
+    return value.load(std::memory_order_relaxed);
+}
+
+double Histogram::Snapshot::getMean() const
+{
+    return (count > 0) ? (sum / static_cast<double>(count)) : 0.0;
+}
+
+double Histogram::Snapshot::getPercentile(const double p) const
+{
+    if (count == 0)
+    {
+        return 0.0;
+    }
+
+    // Rank of the sample, counting from 1.
+    const uint64_t rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(p * static_cast<double>(count))), 1);
+    uint64_t cumulative_count = 0;
+    for (size_t i = 0; i < upperBounds.size(); ++i)
+    {
+        cumulative_count += counts[i];
+        if (cumulative_count >= rank)
+        {
+            return std::min(upperBounds[i], max);
+        }
+    }
+    return max; // Above the last bound.
+}
+
+void Histogram::Snapshot::merge(const Snapshot& other)
+{
+    if (upperBounds.empty() && counts.empty())
+    {
+        *this = other;
+        return;
+    }
+
+    assert(upperBounds == other.upperBounds);
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        counts[i] += other.counts[i];
+    }
+    count += other.count;
+    sum += other.sum;
+    max = std::max(max, other.max);
+}
+
+Histogram::Histogram(std::vector<double> upper_bounds)
+    : upperBounds(std::move(upper_bounds)),
+      counts(std::make_unique<std::atomic<uint64_t>[]>(upperBounds.size() + 1))
+{
+    assert(std::is_sorted(upperBounds.begin(), upperBounds.end()));
+}
+
+std::vector<double> Histogram::makeExponentialBounds(const double first, const double factor, const size_t num_buckets)
+{
+    std::vector<double> bounds;
+    bounds.reserve(num_buckets);
+
+    double bound = first;
+    for (size_t i = 0; i < num_buckets; ++i)
+    {
+        bounds.push_back(bound);
+        bound *= factor;
+    }
+    return bounds;
+}
+
+void Histogram::record(const double value)
+{
+    const size_t bucket = std::lower_bound(upperBounds.begin(), upperBounds.end(), value) - upperBounds.begin();
+    counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+    updateMax(max, value);
+}
+
+Histogram::Snapshot Histogram::getSnapshot() const
+{
+    // The fields are read one at a time, so a snapshot taken while values are being recorded can be off by those few
+    // values; that's fine for monitoring.
+    Snapshot snapshot;
+    snapshot.upperBounds = upperBounds;
+    snapshot.counts.resize(upperBounds.size() + 1);
+    for (size_t i = 0; i < snapshot.counts.size(); ++i)
+    {
+        snapshot.counts[i] = counts[i].load(std::memory_order_relaxed);
+    }
+    snapshot.count = count.load(std::memory_order_relaxed);
+    snapshot.sum = sum.load(std::memory_order_relaxed);
+    snapshot.max = max.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+Histogram::Snapshot Histogram::takeSnapshot()
+{
+    Snapshot snapshot;
+    snapshot.upperBounds = upperBounds;
+    snapshot.counts.resize(upperBounds.size() + 1);
+    for (size_t i = 0; i < snapshot.counts.size(); ++i)
+    {
+        snapshot.counts[i] = counts[i].exchange(0, std::memory_order_relaxed);
+    }
+    snapshot.count = count.exchange(0, std::memory_order_relaxed);
+    snapshot.sum = sum.exchange(0.0, std::memory_order_relaxed);
+    snapshot.max = max.exchange(0.0, std::memory_order_relaxed);
+    return snapshot;
+}
+
+Counter& getCounter(const std::string& name)
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    auto& counter = registry.counters[name];
+    if (counter == nullptr)
+    {
+        counter = std::make_unique<Counter>();
+    }
+    return *counter;
+}
+
+Gauge& getGauge(const std::string& name)
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    auto& gauge = registry.gauges[name];
+    if (gauge == nullptr)
+    {
+        gauge = std::make_unique<Gauge>();
+    }
+    return *gauge;
+}
+
+Histogram& getHistogram(const std::string& name, const std::vector<double>& upper_bounds)
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    auto& histogram = registry.histograms[name];
+    if (histogram == nullptr)
+    {
+        histogram = std::make_unique<Histogram>(upper_bounds);
+    }
+    return *histogram;
+}
+
+std::vector<std::pair<std::string, double>> collect(const bool should_reset_histograms)
+{
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    std::vector<std::pair<std::string, double>> values;
+    for (const auto& [name, counter] : registry.counters)
+    {
+        values.emplace_back(name, static_cast<double>(counter->get()));
+    }
+    for (const auto& [name, gauge] : registry.gauges)
+    {
+        values.emplace_back(name, gauge->get());
+    }
+    for (const auto& [name, histogram] : registry.histograms)
+    {
+        const Histogram::Snapshot snapshot =
+            should_reset_histograms ? histogram->takeSnapshot() : histogram->getSnapshot();
+        values.emplace_back(name + ".count", static_cast<double>(snapshot.count));
+        values.emplace_back(name + ".mean", snapshot.getMean());
+        values.emplace_back(name + ".p50", snapshot.getPercentile(0.5));
+        values.emplace_back(name + ".p99", snapshot.getPercentile(0.99));
+        values.emplace_back(name + ".max", snapshot.max);
+    }
+
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+SnapshotWriter::SnapshotWriter(const std::filesystem::path& path, const std::chrono::milliseconds interval)
+    : file(path, std::ios::app), isCsv(path.extension() == ".csv"), interval(interval),
+      startTime(std::chrono::steady_clock::now()), lastWriteTime(startTime)
+{
+}
+
+bool SnapshotWriter::isOpen() const
+{
+    return file.is_open();
+}
+
+void SnapshotWriter::update()
+{
+    if (std::chrono::steady_clock::now() - lastWriteTime >= interval)
+    {
+        write();
+    }
+}
+
+void SnapshotWriter::write()
+{
+    if (!file.is_open())
+    {
+        return;
+    }
+
+    lastWriteTime = std::chrono::steady_clock::now();
+    const double time = toSeconds(lastWriteTime - startTime);
+    const std::vector<std::pair<std::string, double>> values = collect(true);
+
+    if (isCsv)
+    {
+        std::vector<std::string> columns;
+        columns.reserve(values.size());
+        for (const auto& [name, value] : values)
+        {
+            columns.push_back(name);
+        }
+        if (columns != csvColumns)
+        {
+            csvColumns = std::move(columns);
+            file << "time_s";
+            for (const auto& column : csvColumns)
+            {
+                file << "," << column;
+            }
+            file << "\n";
+        }
+
+        file << time;
+        for (const auto& [name, value] : values)
+        {
+            file << "," << value;
+        }
+        file << "\n";
+    }
+    else
+    {
+        file << "{\"time_s\":" << time;
+        for (const auto& [name, value] : values)
+        {
+            file << ",\"" << name << "\":" << value;
+        }
+        file << "}\n";
+    }
+
+    // Flushed every time so that the file is complete up to the last snapshot even if the game crashes.
+    file.flush();
+}
+
+} // namespace VmcMetrics
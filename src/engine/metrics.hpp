@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Named counters, gauges and histograms that can be updated from any thread without locks, for graphing the state of
+// the game over long sessions. Metrics are registered once by name (registration does lock) and live until the program
+// exits, so callers keep the returned reference instead of looking the metric up again.
+namespace VmcMetrics
+{
+
+// Monotonically increasing total, e.g. the number of chunks generated.
+class Counter
+{
+  private:
+    std::atomic<uint64_t> value = 0;
+
+  public:
+    void add(const uint64_t amount = 1);
+    uint64_t get() const;
+};
+
+// Current value of something that goes up and down, e.g. the number of visible chunks.
+class Gauge
+{
+  private:
+    std::atomic<double> value = 0.0;
+
+  public:
+    void set(const double new_value);
+    void add(const double amount);
+    double get() const;
+};
+
+// Distribution of values in fixed buckets; percentiles are resolved to the upper bound of the bucket they fall in.
+class Histogram
+{
+  public:
+    struct Snapshot
+    {
+        std::vector<double> upperBounds;
+        std::vector<uint64_t> counts; // One per bucket, plus one for values above the last bound.
+        uint64_t count = 0;
+        double sum = 0.0;
+        double max = 0.0;
+
+        double getMean() const;
+        double getPercentile(const double p) const; // `p` is in [0, 1].
+
+        void merge(const Snapshot& other); // Both must come from histograms with the same bounds.
+    };
+
+  private:
+    std::vector<double> upperBounds; // Ascending.
+    std::unique_ptr<std::atomic<uint64_t>[]> counts;
+    std::atomic<uint64_t> count = 0;
+    std::atomic<double> sum = 0.0;
+    std::atomic<double> max = 0.0;
+
+  public:
+    explicit Histogram(std::vector<double> upper_bounds);
+
+    // `num_buckets` bounds starting at `first` and growing by `factor`.
+    static std::vector<double> makeExponentialBounds(const double first, const double factor, const size_t num_buckets);
+
+    void record(const double value);
+
+    Snapshot getSnapshot() const;
+    Snapshot takeSnapshot(); // Also clears the histogram, so the next snapshot only covers what was recorded since.
+};
+
+Counter& getCounter(const std::string& name);
+Gauge& getGauge(const std::string& name);
+Histogram& getHistogram(const std::string& name, const std::vector<double>& upper_bounds); // Bounds of the first call.
+
+// Flattened values of every metric, sorted by name. Histograms become `<name>.count`, `.mean`, `.p50`, `.p99` and
+// `.max`, and are cleared if `should_reset_histograms` so that each snapshot describes its own interval.
+std::vector<std::pair<std::string, double>> collect(const bool should_reset_histograms);
+
+// Appends a snapshot of every metric to a file at a fixed interval. Files ending in `.csv` get a CSV row per snapshot
+// (with a new header row whenever the set of metrics changes); anything else gets one JSON object per line.
+class SnapshotWriter
+{
+  private:
+    std::ofstream file;
+    bool isCsv;
+    std::chrono::steady_clock::duration interval;
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point lastWriteTime;
+    std::vector<std::string> csvColumns;
+
+  public:
+    SnapshotWriter(const std::filesystem::path& path, const std::chrono::milliseconds interval);
+
+    bool isOpen() const;
+
+    void update(); // Writes a snapshot if the interval has passed since the last one.
+    void write();
+};
+
+} // namespace VmcMetrics
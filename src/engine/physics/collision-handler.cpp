@@ -1,10 +1,100 @@
 #include "collision-handler.hpp"
+#include "simd-lanes.hpp"
 
 #include "glm/gtx/component_wise.hpp"
 
 #include <array>
 #include <limits>
-#include <stdexcept>
+
+namespace
+{
+using VmcSimd::ScalarLanes;
+using VmcSimd::SimdLanes;
+
+// Same as the scalar `sweptAabbPerAxis` without the normal, for `Lanes::WIDTH` boxes starting at `first`. Boxes
+// without a collision get infinity. The velocity is the same for every box, so its branches stay scalar.
+template <typename Lanes>
+typename Lanes::Float sweptAabbPerAxisLanes(
+    const glm::vec3& a_min_bounds,
+    const glm::vec3& a_max_edges,
+    const Aabb3dBatch& b,
+    const size_t first,
+    const glm::vec3& a_velocity,
+    const float dt)
+{
+    using Float = typename Lanes::Float;
+    using Mask = typename Lanes::Mask;
+
+    Float entry_times[3];
+    Float exit_times[3];
+    for (glm::length_t axis = 0; axis < 3; ++axis)
+    {
+        if (a_velocity[axis] == 0.0f)
+        {
+            entry_times[axis] = Lanes::set(-std::numeric_limits<float>::infinity());
+            exit_times[axis] = Lanes::set(std::numeric_limits<float>::infinity());
+            continue;
+        }
+
+        const Float b_min = Lanes::load(b.getMinBounds(axis) + first);
+        const Float b_dim = Lanes::sub(Lanes::load(b.getMaxBounds(axis) + first), b_min);
+
+        Float inverse_entry = Lanes::sub(b_min, Lanes::set(a_max_edges[axis]));
+        Float inverse_exit = Lanes::sub(Lanes::add(b_min, b_dim), Lanes::set(a_min_bounds[axis]));
+        if (a_velocity[axis] <= 0.0f)
+        {
+            std::swap(inverse_entry, inverse_exit);
+        }
+
+        const Float velocity = Lanes::set(a_velocity[axis]);
+        entry_times[axis] = Lanes::div(inverse_entry, velocity);
+        exit_times[axis] = Lanes::div(inverse_exit, velocity);
+    }
+
+    const Float t_min = Lanes::max(Lanes::max(entry_times[0], entry_times[1]), entry_times[2]);
+    const Float t_max = Lanes::min(Lanes::min(exit_times[0], exit_times[1]), exit_times[2]);
+
+    const Float zero = Lanes::set(0.0f);
+    const Float dt_lanes = Lanes::set(dt);
+    const Mask all_behind = Lanes::maskAnd(
+        Lanes::maskAnd(Lanes::lessThan(entry_times[0], zero), Lanes::lessThan(entry_times[1], zero)),
+        Lanes::lessThan(entry_times[2], zero));
+    const Mask any_too_late = Lanes::maskOr(
+        Lanes::maskOr(Lanes::lessThan(dt_lanes, entry_times[0]), Lanes::lessThan(dt_lanes, entry_times[1])),
+        Lanes::lessThan(dt_lanes, entry_times[2]));
+    const Mask no_collision = Lanes::maskOr(Lanes::maskOr(Lanes::lessThan(t_max, t_min), all_behind), any_too_late);
+
+    return Lanes::select(no_collision, Lanes::set(std::numeric_limits<float>::infinity()), t_min);
+}
+
+// Same as the scalar AABB overlap test for `Lanes::WIDTH` boxes starting at `first`; bit `i` is set if box
+// `first + i` overlaps.
+template <typename Lanes>
+unsigned aabb3dBatchIntersectLanes(
+    const glm::vec3& a_min_bounds,
+    const glm::vec3& a_max_bounds,
+    const Aabb3dBatch& b,
+    const size_t first,
+    const bool consider_edges)
+{
+    using Mask = typename Lanes::Mask;
+
+    Mask overlap{};
+    for (glm::length_t axis = 0; axis < 3; ++axis)
+    {
+        const auto b_min = Lanes::load(b.getMinBounds(axis) + first);
+        const auto b_max = Lanes::load(b.getMaxBounds(axis) + first);
+        const auto a_min = Lanes::set(a_min_bounds[axis]);
+        const auto a_max = Lanes::set(a_max_bounds[axis]);
+
+        const Mask axis_overlap = consider_edges
+                                      ? Lanes::maskAnd(Lanes::lessEqual(a_min, b_max), Lanes::lessEqual(b_min, a_max))
+                                      : Lanes::maskAnd(Lanes::lessThan(a_min, b_max), Lanes::lessThan(b_min, a_max));
+        overlap = (axis == 0) ? axis_overlap : Lanes::maskAnd(overlap, axis_overlap);
+    }
+    return Lanes::toBits(overlap);
+}
+} // namespace
 
 bool CollisionHandler::rayToAabb3dIntersect(
     const Ray& ray,
@@ -53,7 +143,7 @@ bool CollisionHandler::rayToAabb3dIntersect(
             if (out_face_exit != nullptr)
             {
                 *out_face_exit = glm::ivec3(0);
-                (*out_face_enter)[i] = (inv_ray_d_component < 0) ? 1 : -1;
+                (*out_face_exit)[i] = (inv_ray_d_component < 0) ? -1 : 1;
             }
             t_max = next_t_max;
         }
@@ -92,12 +182,27 @@ bool CollisionHandler::rayToAabb3dIntersect(
     return true;
 }
 
+bool CollisionHandler::aabb3dToAabb3dIntersect(const Aabb3d& a, const Aabb3d& b, const bool consider_edges)
+{
+    const glm::vec3 a_min = a.getMinBounds();
+    const glm::vec3 a_max = a.getMaxBounds();
+    const glm::vec3 b_min = b.getMinBounds();
+    const glm::vec3 b_max = b.getMaxBounds();
+
+    if (consider_edges)
+    {
+        return (a_min.x <= b_max.x) && (b_min.x <= a_max.x) && (a_min.y <= b_max.y) && (b_min.y <= a_max.y) &&
+               (a_min.z <= b_max.z) && (b_min.z <= a_max.z);
+    }
+    return (a_min.x < b_max.x) && (b_min.x < a_max.x) && (a_min.y < b_max.y) && (b_min.y < a_max.y) &&
+           (a_min.z < b_max.z) && (b_min.z < a_max.z);
+}
+
 bool CollisionHandler::aabb3dToAabb3dIntersect(
     const Aabb3d& a,
     const Aabb3d& b,
     const bool consider_edges,
-    std::vector<std::any>* a_info,
-    std::vector<std::any>* b_info)
+    glm::vec3& out_overlap)
 {
     constexpr glm::length_t dim = 3;
     const auto a_min = a.getMinBounds();
@@ -122,97 +227,15 @@ bool CollisionHandler::aabb3dToAabb3dIntersect(
     }
 
     const bool does_overlap = do_axes_overlap[0] && do_axes_overlap[1] && do_axes_overlap[2];
-
-    // Put the results into `a_info` and `b_info`.
-    if (does_overlap && (a_info != nullptr))
+    if (does_overlap)
     {
-        a_info->resize(dim);
-        if (b_info != nullptr)
-        {
-            b_info->resize(dim);
-        }
-
-        for (glm::length_t i = 0; i < dim; ++i)
-        {
-            if (!do_axes_overlap[i])
-            {
-                continue;
-            }
-
-            (*a_info)[i] = overlap_vector[i];
-            if (b_info != nullptr)
-            {
-                (*b_info)[i] = -overlap_vector[i];
-            }
-        }
+        out_overlap = overlap_vector;
     }
 
     // Return whether the AABBs overlapped.
     return does_overlap;
 }
 
-bool CollisionHandler::rayToShapeIntersect(
-    const Ray& ray,
-    const Shape& shape,
-    float* out_t_min,
-    float* out_t_max,
-    glm::ivec3* out_face_enter,
-    glm::ivec3* out_face_exit)
-{
-    switch (shape.getShapeType())
-    {
-    case Shape::Type::AABB_3D:
-        return rayToAabb3dIntersect(
-            ray,
-            static_cast<const Aabb3d&>(shape),
-            out_t_min,
-            out_t_max,
-            out_face_enter,
-            out_face_exit);
-    default:
-        throw std::runtime_error(
-            "Unsupported shape for a shape-ray intersection test: " + Shape::toString(shape.getShapeType()));
-    }
-    return false;
-}
-
-bool CollisionHandler::shapeToShapeIntersect(
-    const Shape& a,
-    const Shape& b,
-    const bool consider_edges,
-    std::vector<std::any>* a_info,
-    std::vector<std::any>* b_info)
-{
-    if (a_info != nullptr)
-    {
-        a_info->clear();
-    }
-    if (b_info != nullptr)
-    {
-        b_info->clear();
-    }
-
-    // TODO: find a more scalable way to implement this.
-    if ((a.getShapeType() == Shape::Type::AABB_3D) && (b.getShapeType() == Shape::Type::AABB_3D))
-    {
-        // Box3D and Box3D.
-        return aabb3dToAabb3dIntersect(
-            static_cast<const Aabb3d&>(a),
-            static_cast<const Aabb3d&>(b),
-            consider_edges,
-            a_info,
-            b_info);
-    }
-    else
-    {
-        // Intersection not supported/unimplemented.
-        throw std::runtime_error(
-            "Unsupported shape combination for shape-to-shape intersection test: (one) " +
-            Shape::toString(a.getShapeType()) + " and (two) " + Shape::toString(b.getShapeType()));
-    }
-    return false;
-}
-
 [[nodiscard]] Aabb3d CollisionHandler::getBroadPhaseAabb(const Aabb3d& a, const glm::vec3& a_velocity, const float dt)
 {
     const glm::vec3 displacement = a_velocity * dt;
@@ -325,6 +348,102 @@ float CollisionHandler::sweptAabbPerAxis(
     return sweptAabbPerAxis(a, b, (a_velocity - b_velocity), dt, normal);
 }
 
+float CollisionHandler::sweptAabbPerAxis(
+    const Aabb3d& a,
+    const Aabb3dBatch& b,
+    const glm::vec3& a_velocity,
+    const float dt,
+    glm::vec3& normal,
+    size_t* out_index)
+{
+    normal = {};
+
+    // Computed the same way as in the scalar version so that the results are identical.
+    const glm::vec3 a_min_bounds = a.getMinBounds();
+    const glm::vec3 a_max_edges = a_min_bounds + a.getDim();
+
+    // Keep the first box with the smallest time, like testing the boxes one by one in order would.
+    float t_min = std::numeric_limits<float>::infinity();
+    size_t t_min_index = b.size();
+
+    const size_t num_aabbs = b.size();
+    size_t i = 0;
+    for (; i + SimdLanes::WIDTH <= num_aabbs; i += SimdLanes::WIDTH)
+    {
+        const auto times = sweptAabbPerAxisLanes<SimdLanes>(a_min_bounds, a_max_edges, b, i, a_velocity, dt);
+        if (SimdLanes::toBits(SimdLanes::lessThan(times, SimdLanes::set(t_min))) == 0)
+        {
+            continue;
+        }
+
+        std::array<float, SimdLanes::WIDTH> lane_times;
+        SimdLanes::store(lane_times.data(), times);
+        for (size_t lane = 0; lane < SimdLanes::WIDTH; ++lane)
+        {
+            if (lane_times[lane] < t_min)
+            {
+                t_min = lane_times[lane];
+                t_min_index = i + lane;
+            }
+        }
+    }
+    for (; i < num_aabbs; ++i)
+    {
+        const float time = sweptAabbPerAxisLanes<ScalarLanes>(a_min_bounds, a_max_edges, b, i, a_velocity, dt);
+        if (time < t_min)
+        {
+            t_min = time;
+            t_min_index = i;
+        }
+    }
+
+    if (out_index != nullptr)
+    {
+        *out_index = t_min_index;
+    }
+    if (t_min_index == num_aabbs)
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    // Only the closest box needs a normal.
+    return sweptAabbPerAxis(a, b.get(t_min_index), a_velocity, dt, normal);
+}
+
+size_t CollisionHandler::aabb3dBatchIntersect(
+    const Aabb3d& a,
+    const Aabb3dBatch& b,
+    std::vector<uint32_t>& out_indices,
+    const bool consider_edges)
+{
+    const size_t prev_size = out_indices.size();
+    const glm::vec3 a_min_bounds = a.getMinBounds();
+    const glm::vec3 a_max_bounds = a.getMaxBounds();
+
+    const size_t num_aabbs = b.size();
+    size_t i = 0;
+    for (; i + SimdLanes::WIDTH <= num_aabbs; i += SimdLanes::WIDTH)
+    {
+        unsigned bits = aabb3dBatchIntersectLanes<SimdLanes>(a_min_bounds, a_max_bounds, b, i, consider_edges);
+        for (size_t lane = 0; bits != 0; ++lane, bits >>= 1)
+        {
+            if (bits & 1u)
+            {
+                out_indices.push_back(static_cast<uint32_t>(i + lane));
+            }
+        }
+    }
+    for (; i < num_aabbs; ++i)
+    {
+        if (aabb3dBatchIntersectLanes<ScalarLanes>(a_min_bounds, a_max_bounds, b, i, consider_edges) != 0)
+        {
+            out_indices.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    return out_indices.size() - prev_size;
+}
+
 float CollisionHandler::sweptAabbMinkowski(
     const Aabb3d& a,
     const Aabb3d& b,
@@ -1,15 +1,23 @@
 #pragma once
 
 #include "ray/ray.hpp"
+#include "shapes/aabb-batch.hpp"
 #include "shapes/aabb.hpp"
 #include "shapes/plane.hpp"
 
-#include <any>
+#include <cstdint>
+#include <type_traits>
 #include <vector>
 
+// Intersection tests between shapes.
+// Shape pairs are resolved at compile time: the templated entry points forward to the matching test for the concrete
+// types, and unsupported combinations fail to compile instead of throwing.
 class CollisionHandler
 {
   private:
+    template <typename T>
+    static constexpr bool UNSUPPORTED_SHAPE = false;
+
     static bool rayToAabb3dIntersect(
         const Ray& ray,
         const Aabb3d& aabb,
@@ -18,28 +26,67 @@ class CollisionHandler
         glm::ivec3* out_face_enter = nullptr,
         glm::ivec3* out_face_exit = nullptr);
 
+    static bool aabb3dToAabb3dIntersect(const Aabb3d& a, const Aabb3d& b, const bool consider_edges);
     static bool aabb3dToAabb3dIntersect(
         const Aabb3d& a,
         const Aabb3d& b,
-        const bool consider_edges = true,
-        std::vector<std::any>* a_info = nullptr,
-        std::vector<std::any>* b_info = nullptr);
+        const bool consider_edges,
+        glm::vec3& out_overlap);
 
   public:
+    template <typename ShapeT>
     static bool rayToShapeIntersect(
         const Ray& ray,
-        const Shape& shape,
+        const ShapeT& shape,
         float* out_t_min = nullptr,
         float* out_t_max = nullptr,
         glm::ivec3* out_face_enter = nullptr, // TODO: these face parameters don't make sense for a general method.
-        glm::ivec3* out_face_exit = nullptr);
+        glm::ivec3* out_face_exit = nullptr)
+    {
+        if constexpr (std::is_same_v<ShapeT, Aabb3d>)
+        {
+            return rayToAabb3dIntersect(ray, shape, out_t_min, out_t_max, out_face_enter, out_face_exit);
+        }
+        else
+        {
+            static_assert(UNSUPPORTED_SHAPE<ShapeT>, "Unsupported shape for a shape-ray intersection test.");
+        }
+    }
+
+    template <typename ShapeA, typename ShapeB>
+    static bool shapeToShapeIntersect(const ShapeA& a, const ShapeB& b, const bool consider_edges = true)
+    {
+        if constexpr (std::is_same_v<ShapeA, Aabb3d> && std::is_same_v<ShapeB, Aabb3d>)
+        {
+            return aabb3dToAabb3dIntersect(a, b, consider_edges);
+        }
+        else
+        {
+            static_assert(
+                UNSUPPORTED_SHAPE<ShapeA>,
+                "Unsupported shape combination for shape-to-shape intersection test.");
+        }
+    }
 
+    // Also gets how far `a` would have to move along each axis to stop overlapping `b` (the shorter way).
+    template <typename ShapeA, typename ShapeB>
     static bool shapeToShapeIntersect(
-        const Shape& a,
-        const Shape& b,
-        const bool consider_edges = true,
-        std::vector<std::any>* a_info = nullptr,
-        std::vector<std::any>* b_info = nullptr);
+        const ShapeA& a,
+        const ShapeB& b,
+        const bool consider_edges,
+        glm::vec3& out_overlap)
+    {
+        if constexpr (std::is_same_v<ShapeA, Aabb3d> && std::is_same_v<ShapeB, Aabb3d>)
+        {
+            return aabb3dToAabb3dIntersect(a, b, consider_edges, out_overlap);
+        }
+        else
+        {
+            static_assert(
+                UNSUPPORTED_SHAPE<ShapeA>,
+                "Unsupported shape combination for shape-to-shape intersection test.");
+        }
+    }
 
     [[nodiscard]] static Aabb3d getBroadPhaseAabb(const Aabb3d& a, const glm::vec3& a_velocity, const float dt);
 
@@ -57,6 +104,21 @@ class CollisionHandler
         const float dt,
         glm::vec3& normal);
 
+    // Batched versions of the tests above; they give the same results as testing each box of `b` in order, but test
+    // several boxes at a time with SIMD where available (SSE2, or AVX2 when compiled for it).
+    static float sweptAabbPerAxis(
+        const Aabb3d& a,
+        const Aabb3dBatch& b,
+        const glm::vec3& a_velocity,
+        const float dt,
+        glm::vec3& normal,
+        size_t* out_index = nullptr);
+    static size_t aabb3dBatchIntersect(
+        const Aabb3d& a,
+        const Aabb3dBatch& b,
+        std::vector<uint32_t>& out_indices,
+        const bool consider_edges = true);
+
     static float sweptAabbMinkowski(
         const Aabb3d& a,
         const Aabb3d& b,
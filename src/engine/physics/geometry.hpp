@@ -7,6 +7,4 @@ struct Geometry
         SHAPE,
         RAY,
     };
-
-    virtual Geometry::Type getGeometryType() const = 0;
 };
@@ -5,11 +5,6 @@ Ray::Ray(const glm::vec3 origin, const glm::vec3 direction, const float min, con
 {
 }
 
-Geometry::Type Ray::getGeometryType() const
-{
-    return type;
-}
-
 void Ray::setOrigin(const glm::vec3& o)
 {
     origin = o;
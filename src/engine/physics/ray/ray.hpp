@@ -4,24 +4,22 @@
 
 #include "../../usage/glm-usage.hpp"
 
-class Ray : public Geometry
+class Ray
 {
   private:
-    Geometry::Type type = Geometry::Type::RAY;
-
     glm::vec3 origin;
     glm::vec3 direction;
     float min;
     float max;
 
   public:
+    static constexpr Geometry::Type GEOMETRY_TYPE = Geometry::Type::RAY;
+
     Ray(const glm::vec3 origin,
         const glm::vec3 direction,
         const float min = 0.0f,
         const float max = std::numeric_limits<float>::infinity());
 
-    Geometry::Type getGeometryType() const;
-
     void setOrigin(const glm::vec3& o);    // TODO: implement a better solution.
     void setDirection(const glm::vec3& r); // TODO: implement a better solution.
 
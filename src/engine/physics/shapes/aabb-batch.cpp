@@ -0,0 +1,55 @@
+#include "aabb-batch.hpp"
+
+void Aabb3dBatch::add(const glm::vec3& min_bounds, const glm::vec3& max_bounds)
+{
+    for (glm::length_t axis = 0; axis < 3; ++axis)
+    {
+        minBounds[axis].push_back(min_bounds[axis]);
+        maxBounds[axis].push_back(max_bounds[axis]);
+    }
+}
+
+void Aabb3dBatch::add(const Aabb3d& aabb)
+{
+    add(aabb.getMinBounds(), aabb.getMaxBounds());
+}
+
+void Aabb3dBatch::clear()
+{
+    for (glm::length_t axis = 0; axis < 3; ++axis)
+    {
+        minBounds[axis].clear();
+        maxBounds[axis].clear();
+    }
+}
+
+void Aabb3dBatch::reserve(const size_t num_aabbs)
+{
+    for (glm::length_t axis = 0; axis < 3; ++axis)
+    {
+        minBounds[axis].reserve(num_aabbs);
+        maxBounds[axis].reserve(num_aabbs);
+    }
+}
+
+Aabb3d Aabb3dBatch::get(const size_t index) const
+{
+    return Aabb3d(
+        glm::vec3(minBounds[0][index], minBounds[1][index], minBounds[2][index]),
+        glm::vec3(maxBounds[0][index], maxBounds[1][index], maxBounds[2][index]));
+}
+
+const float* Aabb3dBatch::getMinBounds(const glm::length_t axis) const
+{
+    return minBounds[axis].data();
+}
+
+const float* Aabb3dBatch::getMaxBounds(const glm::length_t axis) const
+{
+    return maxBounds[axis].data();
+}
+
+size_t Aabb3dBatch::size() const
+{
+    return minBounds[0].size();
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "aabb.hpp"
+
+#include <array>
+#include <vector>
+
+// A list of AABBs stored as structure-of-arrays (one array per bound and axis), so that the batched tests in
+// `CollisionHandler` can load the same bound of several boxes with one instruction.
+class Aabb3dBatch
+{
+  private:
+    std::array<std::vector<float>, 3> minBounds;
+    std::array<std::vector<float>, 3> maxBounds;
+
+  public:
+    void add(const glm::vec3& min_bounds, const glm::vec3& max_bounds);
+    void add(const Aabb3d& aabb);
+    void clear();
+    void reserve(const size_t num_aabbs);
+
+    Aabb3d get(const size_t index) const;
+    const float* getMinBounds(const glm::length_t axis) const;
+    const float* getMaxBounds(const glm::length_t axis) const;
+    size_t size() const;
+};
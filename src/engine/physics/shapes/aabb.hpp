@@ -2,16 +2,18 @@
 
 #include "shape.hpp"
 
-class Aabb3d : public Shape3d
+class Aabb3d
 {
   private:
     glm::vec3 minBounds;
     glm::vec3 maxBounds;
 
   public:
+    static constexpr Shape::Type SHAPE_TYPE = Shape::Type::AABB_3D;
+
     Aabb3d(const glm::vec3& min_bounds, const glm::vec3& max_bounds);
 
-    void translate(const glm::vec3& units) override;
+    void translate(const glm::vec3& units);
 
     glm::vec3 getMinBounds() const;
     glm::vec3 getMaxBounds() const;
@@ -3,13 +3,12 @@
 #include <limits>
 
 Plane3d::Plane3d()
-    : Shape3d(Shape::Type::PLANE_3D), normal(glm::vec3(std::numeric_limits<float>::quiet_NaN())),
-      distance(std::numeric_limits<float>::quiet_NaN())
+    : normal(glm::vec3(std::numeric_limits<float>::quiet_NaN())), distance(std::numeric_limits<float>::quiet_NaN())
 {
 }
 
 Plane3d::Plane3d(const glm::vec3& normal, const glm::vec3& point)
-    : Shape3d(Shape::Type::PLANE_3D), normal(glm::normalize(normal)), distance(glm::dot(this->normal, point))
+    : normal(glm::normalize(normal)), distance(glm::dot(this->normal, point))
 {
 }
 
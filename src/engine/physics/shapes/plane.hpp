@@ -2,17 +2,19 @@
 
 #include "shape.hpp"
 
-class Plane3d : public Shape3d
+class Plane3d
 {
   private:
     glm::vec3 normal;
     float distance; // Distance from the origin to the plane's nearest point.
 
   public:
+    static constexpr Shape::Type SHAPE_TYPE = Shape::Type::PLANE_3D;
+
     Plane3d();
     Plane3d(const glm::vec3& normal, const glm::vec3& point);
 
-    void translate(const glm::vec3& units) override;
+    void translate(const glm::vec3& units);
 
     glm::vec3 getNormal() const;
     float getDistance() const;
@@ -6,12 +6,12 @@
 
 #include <string>
 
-class Shape : public Geometry
+// Shapes are plain value types without virtual functions; each one names its type with a `SHAPE_TYPE` constant, and
+// code that handles several shapes (e.g. `CollisionHandler`) dispatches on the concrete type at compile time.
+struct Shape
 {
-  private:
-    Geometry::Type type = Geometry::Type::SHAPE;
+    static constexpr Geometry::Type GEOMETRY_TYPE = Geometry::Type::SHAPE;
 
-  public:
     enum class Type
     {
         AABB_3D,
@@ -30,21 +30,4 @@ class Shape : public Geometry
             return "UNDEFINED";
         }
     }
-
-    Geometry::Type getGeometryType() const;
-
-    virtual Shape::Type getShapeType() const = 0;
-};
-
-class Shape3d : public Shape
-{
-  private:
-    Shape::Type type;
-
-  protected:
-    Shape3d(const Shape::Type type);
-
-  public:
-    virtual void translate(const glm::vec3& value) = 0;
-    Shape::Type getShapeType() const;
 };
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VMC_SIMD_SSE2
+#endif
+
+// Lane types for batched kernels; each one wraps the same handful of operations for a different vector width so that a
+// kernel is written once as a template and instantiated for `SimdLanes` (the widest available) and `ScalarLanes` (for
+// the remainder). Operand orders mirror `std::min`/`std::max` so that results match scalar code bit for bit, e.g.
+// `std::max(a, b)` returns `a` when they are equal and so does `max(a, b)` here.
+namespace VmcSimd
+{
+struct ScalarLanes
+{
+    using Float = float;
+    using Mask = bool;
+    static constexpr size_t WIDTH = 1;
+
+    static Float load(const float* p)
+    {
+        return *p;
+    }
+    static Float loadIndexed(const float* base, const uint8_t* indices)
+    {
+        return base[indices[0]];
+    }
+    static Float set(const float value)
+    {
+        return value;
+    }
+    static Float add(const Float a, const Float b)
+    {
+        return a + b;
+    }
+    static Float sub(const Float a, const Float b)
+    {
+        return a - b;
+    }
+    static Float mul(const Float a, const Float b)
+    {
+        return a * b;
+    }
+    static Float div(const Float a, const Float b)
+    {
+        return a / b;
+    }
+    static Float min(const Float a, const Float b)
+    {
+        return std::min(a, b);
+    }
+    static Float max(const Float a, const Float b)
+    {
+        return std::max(a, b);
+    }
+    static Mask lessThan(const Float a, const Float b)
+    {
+        return a < b;
+    }
+    static Mask lessEqual(const Float a, const Float b)
+    {
+        return a <= b;
+    }
+    static Mask maskAnd(const Mask a, const Mask b)
+    {
+        return a && b;
+    }
+    static Mask maskOr(const Mask a, const Mask b)
+    {
+        return a || b;
+    }
+    static Float select(const Mask mask, const Float if_true, const Float if_false)
+    {
+        return mask ? if_true : if_false;
+    }
+    static unsigned toBits(const Mask mask)
+    {
+        return mask ? 1u : 0u;
+    }
+    static void store(float* p, const Float value)
+    {
+        *p = value;
+    }
+};
+
+#if defined(__AVX2__)
+struct SimdLanes
+{
+    using Float = __m256;
+    using Mask = __m256;
+    static constexpr size_t WIDTH = 8;
+
+    static Float load(const float* p)
+    {
+        return _mm256_loadu_ps(p);
+    }
+    static Float loadIndexed(const float* base, const uint8_t* indices)
+    {
+        return _mm256_setr_ps(
+            base[indices[0]],
+            base[indices[1]],
+            base[indices[2]],
+            base[indices[3]],
+            base[indices[4]],
+            base[indices[5]],
+            base[indices[6]],
+            base[indices[7]]);
+    }
+    static Float set(const float value)
+    {
+        return _mm256_set1_ps(value);
+    }
+    static Float add(const Float a, const Float b)
+    {
+        return _mm256_add_ps(a, b);
+    }
+    static Float sub(const Float a, const Float b)
+    {
+        return _mm256_sub_ps(a, b);
+    }
+    static Float mul(const Float a, const Float b)
+    {
+        return _mm256_mul_ps(a, b);
+    }
+    static Float div(const Float a, const Float b)
+    {
+        return _mm256_div_ps(a, b);
+    }
+    static Float min(const Float a, const Float b)
+    {
+        return _mm256_min_ps(b, a); // `b < a ? b : a`.
+    }
+    static Float max(const Float a, const Float b)
+    {
+        return _mm256_max_ps(b, a); // `b > a ? b : a`.
+    }
+    static Mask lessThan(const Float a, const Float b)
+    {
+        return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+    }
+    static Mask lessEqual(const Float a, const Float b)
+    {
+        return _mm256_cmp_ps(a, b, _CMP_LE_OQ);
+    }
+    static Mask maskAnd(const Mask a, const Mask b)
+    {
+        return _mm256_and_ps(a, b);
+    }
+    static Mask maskOr(const Mask a, const Mask b)
+    {
+        return _mm256_or_ps(a, b);
+    }
+    static Float select(const Mask mask, const Float if_true, const Float if_false)
+    {
+        return _mm256_blendv_ps(if_false, if_true, mask);
+    }
+    static unsigned toBits(const Mask mask)
+    {
+        return static_cast<unsigned>(_mm256_movemask_ps(mask));
+    }
+    static void store(float* p, const Float value)
+    {
+        _mm256_storeu_ps(p, value);
+    }
+};
+#elif defined(VMC_SIMD_SSE2)
+struct SimdLanes
+{
+    using Float = __m128;
+    using Mask = __m128;
+    static constexpr size_t WIDTH = 4;
+
+    static Float load(const float* p)
+    {
+        return _mm_loadu_ps(p);
+    }
+    static Float loadIndexed(const float* base, const uint8_t* indices)
+    {
+        return _mm_setr_ps(base[indices[0]], base[indices[1]], base[indices[2]], base[indices[3]]);
+    }
+    static Float set(const float value)
+    {
+        return _mm_set1_ps(value);
+    }
+    static Float add(const Float a, const Float b)
+    {
+        return _mm_add_ps(a, b);
+    }
+    static Float sub(const Float a, const Float b)
+    {
+        return _mm_sub_ps(a, b);
+    }
+    static Float mul(const Float a, const Float b)
+    {
+        return _mm_mul_ps(a, b);
+    }
+    static Float div(const Float a, const Float b)
+    {
+        return _mm_div_ps(a, b);
+    }
+    static Float min(const Float a, const Float b)
+    {
+        return _mm_min_ps(b, a); // `b < a ? b : a`.
+    }
+    static Float max(const Float a, const Float b)
+    {
+        return _mm_max_ps(b, a); // `b > a ? b : a`.
+    }
+    static Mask lessThan(const Float a, const Float b)
+    {
+        return _mm_cmplt_ps(a, b);
+    }
+    static Mask lessEqual(const Float a, const Float b)
+    {
+        return _mm_cmple_ps(a, b);
+    }
+    static Mask maskAnd(const Mask a, const Mask b)
+    {
+        return _mm_and_ps(a, b);
+    }
+    static Mask maskOr(const Mask a, const Mask b)
+    {
+        return _mm_or_ps(a, b);
+    }
+    static Float select(const Mask mask, const Float if_true, const Float if_false)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+    }
+    static unsigned toBits(const Mask mask)
+    {
+        return static_cast<unsigned>(_mm_movemask_ps(mask));
+    }
+    static void store(float* p, const Float value)
+    {
+        _mm_storeu_ps(p, value);
+    }
+};
+#else
+using SimdLanes = ScalarLanes;
+#endif
+} // namespace VmcSimd
@@ -0,0 +1,172 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+
+constexpr size_t EVENTS_PER_THREAD = 1 << 15; // Power of 2 so that the ring index is a mask.
+
+struct Event
+{
+    const char* name;
+    int64_t start; // In nanoseconds since `EPOCH`.
+    int64_t duration;
+};
+
+struct ThreadBuffer
+{
+    std::mutex mutex;          // Only contended while a trace is being written.
+    std::vector<Event> events; // Ring buffer; allocated by the thread's first zone.
+    uint64_t numRecorded = 0;  // Total, so `numRecorded & (EVENTS_PER_THREAD - 1)` is the next slot.
+    uint32_t threadId;
+    std::string threadName;
+};
+
+const std::chrono::steady_clock::time_point EPOCH = std::chrono::steady_clock::now();
+
+std::atomic<bool> is_enabled = true;
+
+// Buffers outlive their threads (e.g. a finished worker) so that their zones still show up in the trace.
+std::mutex buffers_mutex;
+std::vector<std::shared_ptr<ThreadBuffer>> buffers; // Guarded by `buffers_mutex`.
+
+ThreadBuffer& getThreadBuffer()
+{
+    thread_local const std::shared_ptr<ThreadBuffer> buffer = [] {
+        auto new_buffer = std::make_shared<ThreadBuffer>();
+
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        new_buffer->threadId = static_cast<uint32_t>(buffers.size());
+        new_buffer->threadName = "Thread " + std::to_string(new_buffer->threadId);
+        buffers.push_back(new_buffer);
+        return new_buffer;
+    }();
+    return *buffer;
+}
+
+int64_t toNanoseconds(const std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+}
+
+void writeEscaped(std::ofstream& file, const std::string& str)
+{
+    for (const char c : str)
+    {
+        if (c == '"' || c == '\\')
+        {
+            file << '\\';
+        }
+        file << c;
+    }
+}
+
+} // namespace
+
+namespace VmcProfiler
+{
+
+Zone::Zone(const char* name) : name(name), isRecording(is_enabled.load(std::memory_order_relaxed))
+{
+    if (isRecording)
+    {
+        startTime = std::chrono::steady_clock::now();
+    }
+}
+
+Zone::~Zone()
+{
+    if (!isRecording)
+    {
+        return;
+    }
+
+    const auto end_time = std::chrono::steady_clock::now();
+    ThreadBuffer& buffer = getThreadBuffer();
+
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.events.empty())
+    {
+        buffer.events.resize(EVENTS_PER_THREAD);
+    }
+    buffer.events[buffer.numRecorded & (EVENTS_PER_THREAD - 1)] = {
+        name,
+        toNanoseconds(startTime - EPOCH),
+        toNanoseconds(end_time - startTime)};
+    ++buffer.numRecorded;
+}
+
+void setThreadName(const std::string& name)
+{
+    ThreadBuffer& buffer = getThreadBuffer();
+
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.threadName = name;
+}
+
+void setEnabled(const bool enabled)
+{
+    is_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool isEnabled()
+{
+    return is_enabled.load(std::memory_order_relaxed);
+}
+
+bool writeChromeTrace(const std::string& path)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        return false;
+    }
+
+    // Timestamps and durations are in microseconds; the fractional part keeps nanosecond precision.
+    file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    file.setf(std::ios::fixed);
+    file.precision(3);
+
+    bool is_first_event = true;
+    const auto begin_event = [&] {
+        file << (is_first_event ? "\n" : ",\n");
+        is_first_event = false;
+    };
+
+    std::lock_guard<std::mutex> buffers_lock(buffers_mutex);
+    for (const auto& buffer : buffers)
+    {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+
+        begin_event();
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+             << ",\"args\":{\"name\":\"";
+        writeEscaped(file, buffer->threadName);
+        file << "\"}}";
+
+        // Oldest first; once the ring has wrapped, the oldest event is in the next slot to be written.
+        const uint64_t num_events = std::min<uint64_t>(buffer->numRecorded, EVENTS_PER_THREAD);
+        for (uint64_t i = buffer->numRecorded - num_events; i < buffer->numRecorded; ++i)
+        {
+            const Event& event = buffer->events[i & (EVENTS_PER_THREAD - 1)];
+
+            begin_event();
+            file << "{\"name\":\"";
+            writeEscaped(file, event.name);
+            file << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                 << ",\"ts\":" << (static_cast<double>(event.start) * 1e-3)
+                 << ",\"dur\":" << (static_cast<double>(event.duration) * 1e-3) << "}";
+        }
+    }
+
+    file << "\n]}" << std::endl;
+    return static_cast<bool>(file);
+}
+
+} // namespace VmcProfiler
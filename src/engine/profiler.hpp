@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Scoped timing zones for finding out where frame and worker time goes.
+// Every thread records its zones into its own fixed-size ring buffer, so recording never waits on other threads and
+// only the most recent zones of each thread are kept. `writeChromeTrace` dumps them as Chrome trace event JSON, which
+// can be opened in Perfetto (ui.perfetto.dev) or chrome://tracing.
+//
+// Use the macros rather than the namespace directly: they compile to nothing unless `VMC_ENABLE_PROFILING` is defined
+// (CMake option of the same name), and a zone costs one flag check while recording is paused at runtime.
+namespace VmcProfiler
+{
+
+// Records the time from its construction to its destruction on the calling thread.
+class Zone
+{
+  private:
+    const char* name; // Must outlive the profiler, e.g. a string literal.
+    std::chrono::steady_clock::time_point startTime;
+    bool isRecording;
+
+  public:
+    explicit Zone(const char* name);
+    Zone(const Zone& other) = delete;
+    Zone(Zone&& other) = delete;
+    ~Zone();
+
+    Zone& operator=(const Zone& other) = delete;
+    Zone& operator=(Zone&& other) = delete;
+};
+
+void setThreadName(const std::string& name); // Shown instead of the thread's id in the trace.
+
+void setEnabled(const bool enabled);
+bool isEnabled();
+
+// Writes the zones currently held by every thread's buffer; returns false if the file couldn't be written.
+bool writeChromeTrace(const std::string& path);
+
+} // namespace VmcProfiler
+
+#if defined(VMC_ENABLE_PROFILING)
+#define VMC_PROFILE_CONCAT_IMPL(a, b) a##b
+#define VMC_PROFILE_CONCAT(a, b) VMC_PROFILE_CONCAT_IMPL(a, b)
+#define VMC_PROFILE_ZONE(name) const VmcProfiler::Zone VMC_PROFILE_CONCAT(vmc_profile_zone_, __LINE__)(name)
+#define VMC_PROFILE_THREAD(name) VmcProfiler::setThreadName(name)
+#else
+#define VMC_PROFILE_ZONE(name) ((void)0)
+#define VMC_PROFILE_THREAD(name) ((void)0)
+#endif
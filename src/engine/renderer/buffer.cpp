@@ -29,26 +29,52 @@ and some Vulkan functions have explicit flags to specify that you want to do thi
 #include <cstring>
 #include <stdexcept>
 
+namespace
+{
+
+MemoryTag getMemoryTag(const VkBufferUsageFlags usage)
+{
+    if (usage & (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT))
+    {
+        return MemoryTag::DEVICE_MESH_BUFFERS;
+    }
+    if (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+    {
+        return MemoryTag::DEVICE_UNIFORM_BUFFERS;
+    }
+    if (usage & VK_BUFFER_USAGE_TRANSFER_SRC_BIT)
+    {
+        return MemoryTag::DEVICE_STAGING_BUFFERS;
+    }
+    return MemoryTag::DEVICE_OTHER_BUFFERS;
+}
+
+} // namespace
+
 Buffer::Buffer(
     const Device& device,
     const VkBufferCreateInfo& create_info,
     const VmaMemoryUsage mem_usage,
     const VmaAllocationCreateFlagBits mem_flags,
     const VkDeviceSize mem_offset)
-    : device(device), size(create_info.size)
+    : device(device), size(create_info.size), memoryTag(getMemoryTag(create_info.usage))
 {
     VmaAllocationCreateInfo alloc_info{};
     alloc_info.usage = mem_usage;
     alloc_info.flags = mem_flags;
 
+    VmaAllocationInfo allocation_info{};
     const VkResult res =
-        vmaCreateBuffer(device.getAllocator(), &create_info, &alloc_info, &buffer, &allocation, nullptr);
+        vmaCreateBuffer(device.getAllocator(), &create_info, &alloc_info, &buffer, &allocation, &allocation_info);
     if (res != VK_SUCCESS)
     {
         std::stringstream err;
         err << "failed to create buffer! code: " << res;
         throw std::runtime_error(err.str());
     }
+
+    allocationSize = allocation_info.size;
+    VmcMemory::recordAllocation(memoryTag, static_cast<size_t>(allocationSize));
 }
 
 Buffer::~Buffer()
@@ -58,6 +84,7 @@ Buffer::~Buffer()
         unmap();
     }
     vmaDestroyBuffer(device.getAllocator(), buffer, allocation);
+    VmcMemory::recordDeallocation(memoryTag, static_cast<size_t>(allocationSize));
 }
 
 void Buffer::map(const VkDeviceSize offset, const VkDeviceSize size)
@@ -1,6 +1,7 @@
 #ifndef VMC_SRC_ENGINE_RENDERER_BUFFER_HPP
 #define VMC_SRC_ENGINE_RENDERER_BUFFER_HPP
 
+#include "../memory-tracking.hpp"
 #include "device.hpp"
 
 class Buffer
@@ -15,6 +16,9 @@ class Buffer
 
     size_t size = 0;
 
+    MemoryTag memoryTag;             // Derived from the usage flags.
+    VkDeviceSize allocationSize = 0; // As allocated by VMA, which may round `size` up.
+
   public:
     Buffer(
         const Device& device,
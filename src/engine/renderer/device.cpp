@@ -174,6 +174,24 @@ static bool checkDeviceExtensionSupport(VkPhysicalDevice device)
     return required_extensions.empty();
 }
 
+static bool isDeviceExtensionAvailable(VkPhysicalDevice device, const char* extension_name)
+{
+    uint32_t extension_count = 0;
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, nullptr);
+
+    std::vector<VkExtensionProperties> available_extensions(extension_count);
+    vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, available_extensions.data());
+
+    for (const auto& extension : available_extensions)
+    {
+        if (strcmp(extension.extensionName, extension_name) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 static SwapchainSupportDetails querySwapChainSupport(VkSurfaceKHR surface, VkPhysicalDevice device)
 {
     SwapchainSupportDetails details{};
@@ -384,14 +402,22 @@ void Device::createLogicalDevice()
     device_features.sampleRateShading = VK_FALSE;
     device_features.fillModeNonSolid = VK_TRUE;
 
+    // Optional extensions.
+    std::vector<const char*> extensions = DEVICE_EXTENSIONS;
+    isMemoryBudgetEnabled = isDeviceExtensionAvailable(physicalDevice, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    if (isMemoryBudgetEnabled)
+    {
+        extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
     // Create the logical device.
     VkDeviceCreateInfo create_info{};
     create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     create_info.pQueueCreateInfos = queue_create_infos.data();
     create_info.queueCreateInfoCount = static_cast<uint32_t>(queue_create_infos.size());
     create_info.pEnabledFeatures = &device_features;
-    create_info.ppEnabledExtensionNames = DEVICE_EXTENSIONS.data();
-    create_info.enabledExtensionCount = static_cast<uint32_t>(DEVICE_EXTENSIONS.size());
+    create_info.ppEnabledExtensionNames = extensions.data();
+    create_info.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
     if (ENABLE_VALIDATION_LAYERS)
     {
         create_info.enabledLayerCount = static_cast<uint32_t>(VALIDATION_LAYERS.size());
@@ -436,7 +462,8 @@ void Device::createAllocator()
     vma_vulkan_func.vkCmdCopyBuffer = vkCmdCopyBuffer;
 
     VmaAllocatorCreateInfo create_info{};
-    create_info.flags = VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    // Without the extension VMA estimates usage from its own allocations and budgets from the heap sizes.
+    create_info.flags = isMemoryBudgetEnabled ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0;
     create_info.vulkanApiVersion = VK_API_VERSION_1_0;
     create_info.physicalDevice = physicalDevice;
     create_info.device = logicalDevice;
@@ -796,6 +823,16 @@ const VkPhysicalDeviceProperties Device::getPhysicalDeviceProperties() const
     return properties;
 }
 
+const std::vector<VmaBudget> Device::getHeapBudgets() const
+{
+    const VkPhysicalDeviceMemoryProperties* memory_properties = nullptr;
+    vmaGetMemoryProperties(allocator, &memory_properties);
+
+    std::vector<VmaBudget> budgets(memory_properties->memoryHeapCount);
+    vmaGetHeapBudgets(allocator, budgets.data());
+    return budgets;
+}
+
 const Window& Device::getWindow() const
 {
     return window;
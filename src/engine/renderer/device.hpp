@@ -40,6 +40,7 @@ class Device
     VkQueue presentQueue = VK_NULL_HANDLE;
 
     VkSampleCountFlagBits msaaSamples = VK_SAMPLE_COUNT_1_BIT;
+    bool isMemoryBudgetEnabled = false; // `VK_EXT_memory_budget`, for the driver's own usage and budget per heap.
 
     void createInstance();
     void setupDebugMessenger();
@@ -86,6 +87,7 @@ class Device
     const SwapchainSupportDetails getSwapchainSupportDetails() const;
     const VkSampleCountFlagBits getMsaaSamples() const;
     const VkPhysicalDeviceProperties getPhysicalDeviceProperties() const;
+    const std::vector<VmaBudget> getHeapBudgets() const; // One per memory heap; cheap enough to query every frame.
 
     const Window& getWindow() const;
     const VkInstance getInstance() const;
@@ -0,0 +1,213 @@
+#include "mesh-optimizer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+
+// Simulated cache; a few more entries than real hardware has does no harm since the score decays towards the end.
+constexpr int CACHE_SIZE = 32;
+
+constexpr float CACHE_DECAY_POWER = 1.5f;
+constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+constexpr float VALENCE_BOOST_SCALE = 2.0f;
+constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+// Vertices in the cache score higher the more recently they were used, except that the 3 of the last triangle score a
+// bit lower so that strips don't just fan around one vertex; vertices with few triangles left score higher so that
+// they are finished off and don't have to be loaded again later.
+float getVertexScore(const int cache_pos, const uint32_t num_remaining_triangles)
+{
+    if (num_remaining_triangles == 0)
+    {
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    if (cache_pos >= 0)
+    {
+        if (cache_pos < 3)
+        {
+            score = LAST_TRIANGLE_SCORE;
+        }
+        else
+        {
+            const float scale = 1.0f / static_cast<float>(CACHE_SIZE - 3);
+            score = std::pow(1.0f - static_cast<float>(cache_pos - 3) * scale, CACHE_DECAY_POWER);
+        }
+    }
+    score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(num_remaining_triangles), -VALENCE_BOOST_POWER);
+    return score;
+}
+
+} // namespace
+
+namespace VmcMeshOptimizer
+{
+
+void optimizeVertexCache(uint32_t* indices, const size_t num_indices, const size_t num_vertices)
+{
+    assert(num_indices % 3 == 0);
+    const size_t num_triangles = num_indices / 3;
+    if (num_triangles == 0)
+    {
+        return;
+    }
+
+    // Triangles of every vertex, packed: the triangles of vertex `v` start at `triangle_offsets[v]`, and the first
+    // `num_remaining_triangles[v]` of them haven't been emitted yet.
+    std::vector<uint32_t> num_remaining_triangles(num_vertices, 0);
+    for (size_t i = 0; i < num_indices; ++i)
+    {
+        assert(indices[i] < num_vertices);
+        ++num_remaining_triangles[indices[i]];
+    }
+    std::vector<uint32_t> triangle_offsets(num_vertices + 1, 0);
+    for (size_t v = 0; v < num_vertices; ++v)
+    {
+        triangle_offsets[v + 1] = triangle_offsets[v] + num_remaining_triangles[v];
+    }
+    std::vector<uint32_t> vertex_triangles(num_indices);
+    {
+        std::vector<uint32_t> fill_counts(num_vertices, 0);
+        for (size_t i = 0; i < num_indices; ++i)
+        {
+            const uint32_t v = indices[i];
+            vertex_triangles[triangle_offsets[v] + fill_counts[v]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    std::vector<float> vertex_scores(num_vertices);
+    for (size_t v = 0; v < num_vertices; ++v)
+    {
+        vertex_scores[v] = getVertexScore(-1, num_remaining_triangles[v]);
+    }
+
+    std::vector<float> triangle_scores(num_triangles);
+    std::vector<bool> is_triangle_emitted(num_triangles, false);
+    for (size_t t = 0; t < num_triangles; ++t)
+    {
+        triangle_scores[t] =
+            vertex_scores[indices[t * 3]] + vertex_scores[indices[t * 3 + 1]] + vertex_scores[indices[t * 3 + 2]];
+    }
+
+    const std::vector<uint32_t> source(indices, indices + num_indices);
+    std::array<uint32_t, CACHE_SIZE + 3> cache{};
+    std::array<uint32_t, CACHE_SIZE + 3> new_cache{};
+    size_t cache_count = 0;
+
+    constexpr uint32_t NO_TRIANGLE = std::numeric_limits<uint32_t>::max();
+    uint32_t best_triangle = NO_TRIANGLE;
+    size_t next_unemitted_triangle = 0; // Everything before it has been emitted.
+
+    for (size_t num_emitted = 0; num_emitted < num_triangles; ++num_emitted)
+    {
+        if (best_triangle == NO_TRIANGLE)
+        {
+            // Nothing in the cache connects to a remaining triangle; take the best of the rest.
+            float best_score = -std::numeric_limits<float>::infinity();
+            while (is_triangle_emitted[next_unemitted_triangle])
+            {
+                ++next_unemitted_triangle;
+            }
+            for (size_t t = next_unemitted_triangle; t < num_triangles; ++t)
+            {
+                if (!is_triangle_emitted[t] && triangle_scores[t] > best_score)
+                {
+                    best_score = triangle_scores[t];
+                    best_triangle = static_cast<uint32_t>(t);
+                }
+            }
+        }
+
+        // Emit the triangle and take it out of its vertices' remaining triangles.
+        const uint32_t* const triangle = &source[best_triangle * 3];
+        std::copy(triangle, triangle + 3, indices + num_emitted * 3);
+        is_triangle_emitted[best_triangle] = true;
+        for (size_t i = 0; i < 3; ++i)
+        {
+            const uint32_t v = triangle[i];
+            uint32_t* const begin = &vertex_triangles[triangle_offsets[v]];
+            uint32_t* const end = begin + num_remaining_triangles[v];
+            std::iter_swap(std::find(begin, end, best_triangle), end - 1);
+            --num_remaining_triangles[v];
+        }
+
+        // Its vertices move to the front of the cache, pushing the others back and possibly out.
+        size_t new_cache_count = 0;
+        for (size_t i = 0; i < 3; ++i)
+        {
+            new_cache[new_cache_count++] = triangle[i];
+        }
+        for (size_t i = 0; i < cache_count; ++i)
+        {
+            const uint32_t v = cache[i];
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+            {
+                new_cache[new_cache_count++] = v;
+            }
+        }
+        cache_count = std::min(new_cache_count, static_cast<size_t>(CACHE_SIZE));
+        std::copy(new_cache.begin(), new_cache.begin() + cache_count, cache.begin());
+
+        // Only the vertices that moved in the cache (or fell out of it) changed score, and with them their triangles;
+        // the best of those is emitted next.
+        for (size_t i = 0; i < new_cache_count; ++i)
+        {
+            const uint32_t v = new_cache[i];
+            const int cache_pos = (i < cache_count) ? static_cast<int>(i) : -1;
+            vertex_scores[v] = getVertexScore(cache_pos, num_remaining_triangles[v]);
+        }
+        best_triangle = NO_TRIANGLE;
+        float best_score = -std::numeric_limits<float>::infinity();
+        for (size_t i = 0; i < new_cache_count; ++i)
+        {
+            const uint32_t v = new_cache[i];
+            for (uint32_t j = 0; j < num_remaining_triangles[v]; ++j)
+            {
+                const uint32_t t = vertex_triangles[triangle_offsets[v] + j];
+                const float score = vertex_scores[source[t * 3]] + vertex_scores[source[t * 3 + 1]] +
+                                    vertex_scores[source[t * 3 + 2]];
+                triangle_scores[t] = score;
+                if (score > best_score)
+                {
+                    best_score = score;
+                    best_triangle = t;
+                }
+            }
+        }
+    }
+}
+
+std::vector<uint32_t> optimizeVertexFetch(uint32_t* indices, const size_t num_indices, const size_t num_vertices)
+{
+    constexpr uint32_t UNUSED = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> remap(num_vertices, UNUSED);
+
+    uint32_t next_vertex = 0;
+    for (size_t i = 0; i < num_indices; ++i)
+    {
+        uint32_t& new_vertex = remap[indices[i]];
+        if (new_vertex == UNUSED)
+        {
+            new_vertex = next_vertex++;
+        }
+        indices[i] = new_vertex;
+    }
+
+    // Vertices that no triangle uses go last, in their original order.
+    for (uint32_t& new_vertex : remap)
+    {
+        if (new_vertex == UNUSED)
+        {
+            new_vertex = next_vertex++;
+        }
+    }
+    return remap;
+}
+
+} // namespace VmcMeshOptimizer
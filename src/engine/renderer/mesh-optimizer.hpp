@@ -0,0 +1,22 @@
+#ifndef VMC_SRC_ENGINE_RENDERER_MESH_OPTIMIZER_HPP
+#define VMC_SRC_ENGINE_RENDERER_MESH_OPTIMIZER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Reordering of indexed triangle lists for the GPU; both keep the mesh itself unchanged.
+namespace VmcMeshOptimizer
+{
+
+// Reorders the triangles so that consecutive triangles share vertices, which lets the post-transform vertex cache skip
+// most vertex shader invocations (Tom Forsyth's "Linear-Speed Vertex Cache Optimisation").
+void optimizeVertexCache(uint32_t* indices, const size_t num_indices, const size_t num_vertices);
+
+// Renumbers the vertices in the order the indices first use them, so vertex fetches walk memory mostly forward.
+// Rewrites `indices` and returns the new position of every old vertex; the vertices have to be moved to match.
+std::vector<uint32_t> optimizeVertexFetch(uint32_t* indices, const size_t num_indices, const size_t num_vertices);
+
+} // namespace VmcMeshOptimizer
+
+#endif // VMC_SRC_ENGINE_RENDERER_MESH_OPTIMIZER_HPP
@@ -1,9 +1,73 @@
 #include "model.hpp"
 
+#include "mesh-optimizer.hpp"
+
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tiny_obj_loader.h>
 
+#include <fstream>
+#include <optional>
+
+namespace
+{
+
+constexpr std::array<char, 8> COOKED_MESH_MAGIC = {'V', 'M', 'C', 'M', 'E', 'S', 'H', '\0'};
+constexpr uint32_t COOKED_MESH_VERSION = 1; // Bump whenever cooking produces something different from the same OBJ.
+
+template <typename T>
+void writeValue(std::ofstream& file, const T& value)
+{
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool readValue(std::ifstream& file, T& value)
+{
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+// 64-bit FNV-1a of the file's contents; empty if it can't be read.
+std::optional<uint64_t> hashFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return std::nullopt;
+    }
+
+    uint64_t hash = 14695981039346656037ull;
+    std::array<char, 1 << 16> buffer;
+    while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0)
+    {
+        for (std::streamsize i = 0; i < file.gcount(); ++i)
+        {
+            hash = (hash ^ static_cast<unsigned char>(buffer[i])) * 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+} // namespace
+
 Model::Model(const std::string model_file_path, const float scale)
+{
+    const std::filesystem::path cooked_path = model_file_path + ".vmcmesh";
+    const std::optional<uint64_t> source_hash = hashFile(model_file_path);
+    if (source_hash.has_value() && loadCookedMesh(cooked_path, source_hash.value(), scale))
+    {
+        return;
+    }
+
+    loadObj(model_file_path, scale);
+    optimize();
+
+    if (source_hash.has_value())
+    {
+        saveCookedMesh(cooked_path, source_hash.value(), scale); // Best effort; it is cooked again next time if not.
+    }
+}
+
+void Model::loadObj(const std::string& model_file_path, const float scale)
 {
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
@@ -51,17 +115,111 @@ Model::Model(const std::string model_file_path, const float scale)
     }
 }
 
-Model::Model(const std::vector<Vertex>& vertices, const std::vector<Index>& indices)
+void Model::optimize()
+{
+    VmcMeshOptimizer::optimizeVertexCache(indices.data(), indices.size(), vertices.size());
+
+    const std::vector<uint32_t> remap =
+        VmcMeshOptimizer::optimizeVertexFetch(indices.data(), indices.size(), vertices.size());
+    VertexContainer remapped_vertices(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        remapped_vertices[remap[i]] = vertices[i];
+    }
+    vertices = std::move(remapped_vertices);
+}
+
+bool Model::loadCookedMesh(const std::filesystem::path& path, const uint64_t source_hash, const float scale)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+
+    // Anything that doesn't match exactly (including the vertex layout of this build) is cooked again.
+    std::array<char, 8> magic{};
+    uint32_t version = 0, vertex_size = 0, num_vertices = 0, num_indices = 0;
+    uint64_t cooked_source_hash = 0;
+    float cooked_scale = 0.0f;
+    if (!readValue(file, magic) || magic != COOKED_MESH_MAGIC || !readValue(file, version) ||
+        version != COOKED_MESH_VERSION || !readValue(file, cooked_source_hash) || cooked_source_hash != source_hash ||
+        !readValue(file, cooked_scale) || cooked_scale != scale || !readValue(file, vertex_size) ||
+        vertex_size != sizeof(Vertex) || !readValue(file, num_vertices) || !readValue(file, num_indices))
+    {
+        return false;
+    }
+
+    const std::streamoff vertices_size = static_cast<std::streamoff>(num_vertices) * sizeof(Vertex);
+    const std::streamoff indices_size = static_cast<std::streamoff>(num_indices) * sizeof(Index);
+    std::error_code error;
+    const uintmax_t file_size = std::filesystem::file_size(path, error);
+    if (error || file_size != static_cast<uintmax_t>(file.tellg() + vertices_size + indices_size))
+    {
+        return false; // Not the size the header promises.
+    }
+
+    VertexContainer cooked_vertices(num_vertices);
+    IndexContainer cooked_indices(num_indices);
+    if (!file.read(reinterpret_cast<char*>(cooked_vertices.data()), vertices_size) ||
+        !file.read(reinterpret_cast<char*>(cooked_indices.data()), indices_size))
+    {
+        return false;
+    }
+
+    vertices = std::move(cooked_vertices);
+    indices = std::move(cooked_indices);
+    return true;
+}
+
+bool Model::saveCookedMesh(const std::filesystem::path& path, const uint64_t source_hash, const float scale) const
+{
+    // Written under a temporary name and moved into place, so an interrupted write never leaves a partial file.
+    std::filesystem::path temp_path = path;
+    temp_path += ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        writeValue(file, COOKED_MESH_MAGIC);
+        writeValue(file, COOKED_MESH_VERSION);
+        writeValue(file, source_hash);
+        writeValue(file, scale);
+        writeValue(file, static_cast<uint32_t>(sizeof(Vertex)));
+        writeValue(file, static_cast<uint32_t>(vertices.size()));
+        writeValue(file, static_cast<uint32_t>(indices.size()));
+        file.write(reinterpret_cast<const char*>(vertices.data()),
+                   static_cast<std::streamsize>(vertices.size() * sizeof(Vertex)));
+        file.write(reinterpret_cast<const char*>(indices.data()),
+                   static_cast<std::streamsize>(indices.size() * sizeof(Index)));
+        if (!file)
+        {
+            file.close();
+            std::error_code error;
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+    return true;
+}
+
+Model::Model(const VertexContainer& vertices, const IndexContainer& indices)
     : vertices(vertices), indices(indices)
 {
 }
 
-const std::vector<Model::Vertex>& Model::getVertices() const
+const Model::VertexContainer& Model::getVertices() const
 {
     return vertices;
 }
 
-const std::vector<Model::Index>& Model::getIndices() const
+const Model::IndexContainer& Model::getIndices() const
 {
     return indices;
 }
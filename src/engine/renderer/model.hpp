@@ -1,12 +1,15 @@
 #ifndef VMC_SRC_ENGINE_RENDERER_MODEL_HPP
 #define VMC_SRC_ENGINE_RENDERER_MODEL_HPP
 
+#include "../memory-tracking.hpp"
 #include "device.hpp"
 
 #include "../usage/glm-usage.hpp"
 #include <glm/gtx/hash.hpp>
 
 #include <array>
+#include <cstdint>
+#include <filesystem>
 
 class Model
 {
@@ -100,22 +103,34 @@ class Model
         alignas(16) glm::mat4 model;
         alignas(16) glm::mat4 view;
         alignas(16) glm::mat4 proj;
+        alignas(16) glm::mat4 viewProj;
+        alignas(16) glm::mat4 normal; // Inverse transpose of `model`; a `mat3` would be padded to the same size anyway.
     };
 
     using Index = uint32_t;
 
+    using VertexContainer = std::vector<Vertex, TrackedAllocator<Vertex, MemoryTag::MESHES>>;
+    using IndexContainer = std::vector<Index, TrackedAllocator<Index, MemoryTag::MESHES>>;
+
   private:
-    std::vector<Vertex> vertices;
-    std::vector<Index> indices;
+    VertexContainer vertices;
+    IndexContainer indices;
     std::vector<glm::vec3> normals;
 
+    void loadObj(const std::string& model_file_path, const float scale);
+    void optimize();
+    bool loadCookedMesh(const std::filesystem::path& path, const uint64_t source_hash, const float scale);
+    bool saveCookedMesh(const std::filesystem::path& path, const uint64_t source_hash, const float scale) const;
+
   public:
     Model() = default;
+    // OBJ files are parsed and optimized once, then loaded from a cooked copy next to them (`<file>.vmcmesh`), which
+    // is cooked again whenever the OBJ's contents change.
     Model(const std::string model_file_path, const float scale = 1.0f);
-    Model(const std::vector<Vertex>& vertices, const std::vector<Index>& indices);
+    Model(const VertexContainer& vertices, const IndexContainer& indices);
 
-    const std::vector<Vertex>& getVertices() const;
-    const std::vector<Index>& getIndices() const;
+    const VertexContainer& getVertices() const;
+    const IndexContainer& getIndices() const;
 
     void translate(const glm::vec3 units);
 };
@@ -127,11 +142,12 @@ template <> struct hash<Model::Vertex>
 {
     size_t operator()(Model::Vertex const& vertex) const
     {
-        const std::size_t h_pos = hash<glm::vec3>{}(vertex.pos);
-        const std::size_t h_normal = hash<glm::vec3>{}(vertex.normal);
-        const std::size_t h_color = hash<glm::vec3>{}(vertex.color);
-        const std::size_t h_tex_coord = hash<glm::vec2>{}(vertex.texCoord);
-        return ((((h_pos ^ (h_normal << 1)) >> 1) ^ (h_color << 1)) >> 1) ^ (h_tex_coord << 1);
+        // Combined in order; XOR-ing shifted hashes made vertices with swapped or mirrored components collide.
+        std::size_t seed = hash<glm::vec3>{}(vertex.pos);
+        glm::detail::hash_combine(seed, hash<glm::vec3>{}(vertex.normal));
+        glm::detail::hash_combine(seed, hash<glm::vec3>{}(vertex.color));
+        glm::detail::hash_combine(seed, hash<glm::vec2>{}(vertex.texCoord));
+        return seed;
     }
 };
 
@@ -1,11 +1,21 @@
 #include "renderer.hpp"
 
 #include "../../utility.hpp"
+#include "../metrics.hpp"
+#include "../profiler.hpp"
 
 #include <chrono>
 #include <iostream>
 #include <stdexcept>
 
+namespace
+{
+
+VmcMetrics::Counter& upload_bytes_counter = VmcMetrics::getCounter("upload_bytes"); // Through staging buffers.
+VmcMetrics::Gauge& draw_calls_gauge = VmcMetrics::getGauge("draw_calls");           // In the last recorded frame.
+
+} // namespace
+
 void Renderer::createDescriptorSetLayout()
 {
     pDescriptorSetLayout = std::make_unique<DescriptorSetLayout>(device, descriptorSetLayoutBindings);
@@ -130,6 +140,8 @@ bool Renderer::addVertexBuffer(
     const size_t instance_count,
     const size_t instance_capacity)
 {
+    VMC_PROFILE_ZONE("Renderer::addVertexBuffer");
+
     vkDeviceWaitIdle(device.getLogicalDevice());
 
     // Bad if empty data OR the `id` is already in use OR the capacity is less than count.
@@ -169,6 +181,7 @@ bool Renderer::addVertexBuffer(
         VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
         VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT);
     vertexBuffers[id].pVertexBuffer->copyFrom(staging_buffer, num_bytes);
+    upload_bytes_counter.add(num_bytes);
 
     // Check if there is per instance data to handle.
     if ((instance_data != nullptr) && (instance_count > 0))
@@ -201,6 +214,7 @@ bool Renderer::addVertexBuffer(
             VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
             VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT);
         vertexBuffers[id].pInstanceVertexBuffer->copyFrom(instance_staging_buffer, num_bytes);
+        upload_bytes_counter.add(num_bytes);
     }
 
     return true;
@@ -208,6 +222,8 @@ bool Renderer::addVertexBuffer(
 
 bool Renderer::updateVertexBuffer(const unsigned id, const void* data, const size_t data_type_size, const size_t count)
 {
+    VMC_PROFILE_ZONE("Renderer::updateVertexBuffer");
+
     vkDeviceWaitIdle(device.getLogicalDevice());
 
     // Ignore if `id` doesn't exist.
@@ -249,6 +265,7 @@ bool Renderer::updateVertexBuffer(const unsigned id, const void* data, const siz
     // TODO: do double buffering.
     // TODO: may need synchronization primitive to render only after update
     vertexBuffers[id].pVertexBuffer->copyFrom(staging_buffer, num_bytes);
+    upload_bytes_counter.add(num_bytes);
 
     return true;
 }
@@ -259,6 +276,8 @@ bool Renderer::updateInstanceVertexBuffer(
     const size_t data_type_size,
     const size_t count)
 {
+    VMC_PROFILE_ZONE("Renderer::updateInstanceVertexBuffer");
+
     vkDeviceWaitIdle(device.getLogicalDevice());
 
     // Ignore if `id` doesn't exist.
@@ -299,6 +318,7 @@ bool Renderer::updateInstanceVertexBuffer(
     // TODO: may need synchronization primitive to render only after update
     vertexBuffers[id].instanceCount = count;
     vertexBuffers[id].pInstanceVertexBuffer->copyFrom(instance_staging_buffer, num_bytes);
+    upload_bytes_counter.add(num_bytes);
 
     return true;
 }
@@ -530,6 +550,8 @@ bool Renderer::addIndexBuffer(
     const size_t count,
     const size_t capacity)
 {
+    VMC_PROFILE_ZONE("Renderer::addIndexBuffer");
+
     vkDeviceWaitIdle(device.getLogicalDevice());
 
     const bool is_vert_buff_exist = vertexBuffers.contains(vertex_buffer_id);
@@ -575,6 +597,7 @@ bool Renderer::addIndexBuffer(
                 VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
                 VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT)));
     vertToIndexBuffers[vertex_buffer_id][index_buffer_id].pBuffer->copyFrom(staging_buffer, num_bytes);
+    upload_bytes_counter.add(num_bytes);
 
     return true;
 }
@@ -586,6 +609,8 @@ bool Renderer::updateIndexBuffer(
     const size_t data_type_size,
     const size_t count)
 {
+    VMC_PROFILE_ZONE("Renderer::updateIndexBuffer");
+
     vkDeviceWaitIdle(device.getLogicalDevice());
 
     const bool is_buffers_not_exist = (!vertexBuffers.contains(vertex_buffer_id)) ||
@@ -627,6 +652,7 @@ bool Renderer::updateIndexBuffer(
     // Create the index buffer and copy the data from the staging buffer into it.
     create_info.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
     index_buffer.pBuffer->copyFrom(staging_buffer, num_bytes);
+    upload_bytes_counter.add(num_bytes);
 
     return true;
 }
@@ -688,6 +714,8 @@ void Renderer::createSyncObjects()
 
 void Renderer::recordCommandBuffer(const VkCommandBuffer command_buffer, const uint32_t image_index)
 {
+    VMC_PROFILE_ZONE("Renderer::recordCommandBuffer");
+
     VkCommandBufferBeginInfo begin_info{};
     begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     begin_info.flags = 0;                  // Optional.
@@ -732,6 +760,7 @@ void Renderer::recordCommandBuffer(const VkCommandBuffer command_buffer, const u
     scissor.extent = swapchain.getExtent();
     vkCmdSetScissor(command_buffer, 0, 1, &scissor);
 
+    unsigned num_draw_calls = 0;
     for (const auto& vert_to_index_buffers_entry : vertToIndexBuffers)
     {
         const unsigned vertex_buffer_id = vert_to_index_buffers_entry.first;
@@ -773,8 +802,10 @@ void Renderer::recordCommandBuffer(const VkCommandBuffer command_buffer, const u
                 0,
                 0,
                 0);
+            ++num_draw_calls;
         }
     }
+    draw_calls_gauge.set(num_draw_calls);
 
     vkCmdEndRenderPass(command_buffer);
 
@@ -842,6 +873,8 @@ unsigned Renderer::addUniformBuffer(
 
 void Renderer::updateUniformBuffer(const unsigned index, const void* data, const size_t num_bytes)
 {
+    VMC_PROFILE_ZONE("Renderer::updateUniformBuffer");
+
     vkWaitForFences(device.getLogicalDevice(), 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
     uniformBuffers[index].bufferPtrPerFrame[currentFrame]->write(data, num_bytes);
 }
@@ -868,6 +901,8 @@ void Renderer::addCombinedImageSampler(
 
 void Renderer::drawFrame()
 {
+    VMC_PROFILE_ZONE("Renderer::drawFrame");
+
     // Common outline of rendering a frame:
     //     1. Wait for the previous frame to finish
     //     2. Acquire an image from the swap chain
@@ -875,8 +910,19 @@ void Renderer::drawFrame()
     //     4. Submit the recorded command buffer
     //     5. Present the swap chain image
 
+    lastFrameTimings = {};
+    auto phase_start_time = std::chrono::steady_clock::now();
+    const auto end_phase = [&phase_start_time](std::chrono::nanoseconds& phase_time) {
+        const auto now = std::chrono::steady_clock::now();
+        phase_time += std::chrono::duration_cast<std::chrono::nanoseconds>(now - phase_start_time);
+        phase_start_time = now;
+    };
+
     // 1.
-    vkWaitForFences(device.getLogicalDevice(), 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+    {
+        VMC_PROFILE_ZONE("Wait for frame fence");
+        vkWaitForFences(device.getLogicalDevice(), 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+    }
 
     // 2.
     uint32_t image_index = 0;
@@ -890,6 +936,7 @@ void Renderer::drawFrame()
     if (result == VK_ERROR_OUT_OF_DATE_KHR)
     {
         swapchain.recreate();
+        end_phase(lastFrameTimings.presentWait);
         return;
     }
     else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
@@ -900,9 +947,12 @@ void Renderer::drawFrame()
     // Only reset the fence if we are submitting work.
     vkResetFences(device.getLogicalDevice(), 1, &inFlightFences[currentFrame]);
 
+    end_phase(lastFrameTimings.presentWait);
+
     // 3.
     vkResetCommandBuffer(commandBuffers[currentFrame], 0);
     recordCommandBuffer(commandBuffers[currentFrame], image_index);
+    end_phase(lastFrameTimings.record);
 
     // 4.
     VkSubmitInfo submit_info{};
@@ -929,6 +979,7 @@ void Renderer::drawFrame()
         err << "failed to submit draw command buffer! VkResult = " << queue_submit_res;
         throw std::runtime_error(err.str());
     }
+    end_phase(lastFrameTimings.submit);
 
     // 5.
     VkPresentInfoKHR present_info{};
@@ -954,10 +1005,21 @@ void Renderer::drawFrame()
     {
         throw std::runtime_error("failed to present swap chain image!");
     }
+    end_phase(lastFrameTimings.presentWait);
 
     currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 }
 
+const Renderer::FrameTimings& Renderer::getLastFrameTimings() const
+{
+    return lastFrameTimings;
+}
+
+const std::vector<VmaBudget> Renderer::getDeviceMemoryBudgets() const
+{
+    return device.getHeapBudgets();
+}
+
 Renderer::IndexBufferInfo::IndexBufferInfo(size_t count, std::unique_ptr<Buffer> p_buffer, VkIndexType type)
     : count(count), pBuffer(std::move(p_buffer)), type(type)
 {
@@ -10,12 +10,22 @@
 #include "texture.hpp"
 #include "window.hpp"
 
+#include <chrono>
 #include <memory>
 
 inline const int MAX_FRAMES_IN_FLIGHT = 2;
 
 class Renderer
 {
+  public:
+    // CPU time spent in each part of `drawFrame`.
+    struct FrameTimings
+    {
+        std::chrono::nanoseconds record{0};      // Recording the command buffer.
+        std::chrono::nanoseconds submit{0};      // Submitting it.
+        std::chrono::nanoseconds presentWait{0}; // Waiting for a frame in flight, acquiring an image and presenting it.
+    };
+
   private:
     uint32_t currentFrame = 0;
     Window& window;
@@ -81,6 +91,8 @@ class Renderer
     std::vector<VkSemaphore> renderFinishedSemaphores;
     std::vector<VkFence> inFlightFences;
 
+    FrameTimings lastFrameTimings;
+
     VkShaderModule createShaderModule(const std::vector<char>& bytecode) const;
     void createDescriptorPool();
     void createCommandBuffers();
@@ -154,6 +166,8 @@ class Renderer
         const VkSampler* immutable_samplers = nullptr);
 
     void drawFrame();
+    const FrameTimings& getLastFrameTimings() const;
+    const std::vector<VmaBudget> getDeviceMemoryBudgets() const;
 };
 
 #endif // VMC_SRC_ENGINE_RENDERER_RENDERER_HPP
@@ -62,13 +62,17 @@ void Texture::createImage(const std::string& texture_file_path)
     image_info.samples = VK_SAMPLE_COUNT_1_BIT;
     image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    const VkResult res = vmaCreateImage(device.getAllocator(), &image_info, &alloc_info, &image, &allocation, nullptr);
+    VmaAllocationInfo allocation_info{};
+    const VkResult res =
+        vmaCreateImage(device.getAllocator(), &image_info, &alloc_info, &image, &allocation, &allocation_info);
     if (res != VK_SUCCESS)
     {
         std::stringstream err;
         err << "failed to create image! code: " << res;
         throw std::runtime_error(err.str());
     }
+    allocationSize = allocation_info.size;
+    VmcMemory::recordAllocation(MemoryTag::DEVICE_TEXTURES, static_cast<size_t>(allocationSize));
 
     // Prepare image for copying into.
     device.transitionImageLayout(
@@ -157,6 +161,7 @@ Texture::~Texture()
     vkDestroySampler(device.getLogicalDevice(), sampler, nullptr);
     vkDestroyImageView(device.getLogicalDevice(), imageView, nullptr);
     vmaDestroyImage(device.getAllocator(), image, allocation);
+    VmcMemory::recordDeallocation(MemoryTag::DEVICE_TEXTURES, static_cast<size_t>(allocationSize));
 }
 
 const VkImageView Texture::getImageView() const
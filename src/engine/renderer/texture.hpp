@@ -1,6 +1,7 @@
 #ifndef VMC_SRC_ENGINE_RENDERER_TEXTURE_HPP
 #define VMC_SRC_ENGINE_RENDERER_TEXTURE_HPP
 
+#include "../memory-tracking.hpp"
 #include "device.hpp"
 
 class Texture
@@ -10,6 +11,7 @@ class Texture
 
     uint32_t mipLevels = 0;
     VmaAllocation allocation = VK_NULL_HANDLE;
+    VkDeviceSize allocationSize = 0;
     VkImage image = VK_NULL_HANDLE;
     VkImageView imageView = VK_NULL_HANDLE;
     VkSampler sampler = VK_NULL_HANDLE;
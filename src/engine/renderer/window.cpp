@@ -64,6 +64,11 @@ VkSurfaceKHR Window::createSurface(VkInstance instance) const
     return surface;
 }
 
+GLFWwindow* Window::getHandle() const
+{
+    return pWindow;
+}
+
 void Window::pollEvents() const
 {
     glfwPollEvents();
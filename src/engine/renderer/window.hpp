@@ -41,6 +41,7 @@ class Window
     Window& operator=(Window&& other) = delete;
 
     VkSurfaceKHR createSurface(VkInstance instance) const;
+    GLFWwindow* getHandle() const; // For talking to GLFW directly, e.g. to feed input to a headless window.
 
     void pollEvents() const;
     bool shouldClose() const;
@@ -0,0 +1,451 @@
+#include "entity-system.hpp"
+
+#include "engine/physics/collision-handler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+Aabb3d EntitySystem::getHitbox(const size_t index) const
+{
+    return Aabb3d(positions[index] + hitboxMins[index], positions[index] + hitboxMaxs[index]);
+}
+
+glm::ivec3 EntitySystem::getCell(const glm::vec3& pos) const
+{
+    return glm::ivec3(glm::floor(pos / cellSize));
+}
+
+size_t EntitySystem::getBucketIndex(const glm::ivec3& cell) const
+{
+    const size_t hash = (static_cast<size_t>(cell.x) * 73856093u) ^ (static_cast<size_t>(cell.y) * 19349663u) ^
+                        (static_cast<size_t>(cell.z) * 83492791u);
+    return hash & (NUM_HASH_BUCKETS - 1);
+}
+
+void EntitySystem::moveEntity(const size_t index, const float dt)
+{
+    uint8_t& entity_flags = flags[index];
+    glm::vec3 velocity = velocities[index];
+    glm::vec3 position = positions[index];
+
+    if (entity_flags & HAS_GRAVITY)
+    {
+        velocity.y += world.getGravity() * dt;
+    }
+    entity_flags &= ~ON_FLOOR;
+
+    if (!(entity_flags & COLLIDES_WITH_TERRAIN))
+    {
+        positions[index] = position + velocity * dt;
+        velocities[index] = velocity;
+        return;
+    }
+
+    // Same sweep and slide response as the player.
+    Aabb3d hitbox = getHitbox(index);
+    float remaining_dt = dt;
+    for (unsigned i = 0; i < MAX_COLLISION_ITERATIONS; ++i)
+    {
+        if (velocity == glm::vec3(0.0f) || remaining_dt <= 0.0f)
+        {
+            break;
+        }
+
+        glm::vec3 normal{};
+        float new_dt = remaining_dt;
+        if (!world.doesEntityIntersect(velocity, remaining_dt, hitbox, new_dt, &normal))
+        {
+            position += velocity * remaining_dt;
+            break;
+        }
+
+        const glm::vec3 displacement = velocity * new_dt + normal * EPSILON;
+        position += displacement;
+        hitbox.translate(displacement);
+        remaining_dt -= new_dt;
+
+        velocity -= normal * glm::dot(velocity, normal);
+
+        if (normal.y > 0.0f)
+        {
+            entity_flags |= ON_FLOOR;
+        }
+    }
+
+    positions[index] = position;
+    velocities[index] = velocity;
+}
+
+void EntitySystem::buildSpatialHash()
+{
+    const size_t num_entities = size();
+
+    cells.resize(num_entities);
+    bucketEntries.resize(num_entities);
+    bucketStarts.assign(NUM_HASH_BUCKETS + 1, 0);
+    maxHalfExtents = glm::vec3(0.0f);
+
+    // Count the entities per bucket.
+    for (size_t i = 0; i < num_entities; ++i)
+    {
+        const glm::vec3 half_extents = (hitboxMaxs[i] - hitboxMins[i]) * 0.5f;
+        maxHalfExtents = glm::max(maxHalfExtents, half_extents);
+
+        cells[i] = getCell(positions[i] + hitboxMins[i] + half_extents);
+        ++bucketStarts[getBucketIndex(cells[i]) + 1];
+    }
+
+    // Turn the counts into the start of each bucket's range, then fill in the ranges.
+    for (size_t b = 0; b < NUM_HASH_BUCKETS; ++b)
+    {
+        bucketStarts[b + 1] += bucketStarts[b];
+    }
+    std::vector<uint32_t> next_entry(bucketStarts.begin(), bucketStarts.end() - 1);
+    for (size_t i = 0; i < num_entities; ++i)
+    {
+        bucketEntries[next_entry[getBucketIndex(cells[i])]++] = static_cast<uint32_t>(i);
+    }
+}
+
+void EntitySystem::findContacts(const size_t index, std::vector<std::pair<uint32_t, uint32_t>>& pairs) const
+{
+    if (!(flags[index] & COLLIDES_WITH_ENTITIES))
+    {
+        return;
+    }
+
+    // An entity is stored by its center, so any entity overlapping this one has its center within the hitbox grown by
+    // the largest half size.
+    const Aabb3d hitbox = getHitbox(index);
+    const glm::ivec3 min_cell = getCell(hitbox.getMinBounds() - maxHalfExtents);
+    const glm::ivec3 max_cell = getCell(hitbox.getMaxBounds() + maxHalfExtents);
+    for (int z = min_cell.z; z <= max_cell.z; ++z)
+    {
+        for (int y = min_cell.y; y <= max_cell.y; ++y)
+        {
+            for (int x = min_cell.x; x <= max_cell.x; ++x)
+            {
+                const glm::ivec3 cell(x, y, z);
+                const size_t bucket = getBucketIndex(cell);
+                for (uint32_t k = bucketStarts[bucket]; k < bucketStarts[bucket + 1]; ++k)
+                {
+                    // Only report each pair once, and skip entities from other cells that share the bucket.
+                    const uint32_t other = bucketEntries[k];
+                    if (other <= index || cells[other] != cell || !(flags[other] & COLLIDES_WITH_ENTITIES))
+                    {
+                        continue;
+                    }
+
+                    if (CollisionHandler::shapeToShapeIntersect(hitbox, getHitbox(other), false))
+                    {
+                        pairs.emplace_back(static_cast<uint32_t>(index), other);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void EntitySystem::pushEntity(const uint32_t index, const glm::vec3& displacement)
+{
+    if (!(flags[index] & COLLIDES_WITH_TERRAIN))
+    {
+        positions[index] += displacement;
+        return;
+    }
+
+    // Swept like a move over a whole time unit, so the push stops at the terrain. The sweep doesn't see blocks the
+    // entity already overlaps, which is why it mustn't be pushed into one in the first place.
+    glm::vec3 normal{};
+    float t = 1.0f;
+    if (world.doesEntityIntersect(displacement, 1.0f, getHitbox(index), t, &normal))
+    {
+        positions[index] += displacement * t + normal * EPSILON;
+    }
+    else
+    {
+        positions[index] += displacement;
+    }
+}
+
+bool EntitySystem::resolveContact(const uint32_t a, const uint32_t b)
+{
+    const Aabb3d a_hitbox = getHitbox(a);
+    const Aabb3d b_hitbox = getHitbox(b);
+
+    // The pairs are all found before any is resolved, so pushing an earlier pair apart can already have separated this
+    // one; pushing it by its (negative) overlap would then pull the entities back together.
+    const glm::vec3 overlap = glm::min(a_hitbox.getMaxBounds(), b_hitbox.getMaxBounds()) -
+                              glm::max(a_hitbox.getMinBounds(), b_hitbox.getMinBounds());
+    if (overlap.x <= 0.0f || overlap.y <= 0.0f || overlap.z <= 0.0f)
+    {
+        return false;
+    }
+
+    // Push both entities apart by half of the overlap along the axis of least overlap.
+    glm::length_t axis = 0;
+    if (overlap[1] < overlap[axis])
+    {
+        axis = 1;
+    }
+    if (overlap[2] < overlap[axis])
+    {
+        axis = 2;
+    }
+
+    const float dir = (a_hitbox.getCenter()[axis] < b_hitbox.getCenter()[axis]) ? -1.0f : 1.0f;
+    const float push = overlap[axis] * 0.5f + EPSILON;
+    glm::vec3 displacement{0.0f};
+    displacement[axis] = dir * push;
+    pushEntity(a, displacement);
+    pushEntity(b, -displacement);
+
+    // Stop them from moving into each other.
+    const float relative_velocity = (velocities[a][axis] - velocities[b][axis]) * dir;
+    if (relative_velocity < 0.0f)
+    {
+        const float shared_velocity = (velocities[a][axis] + velocities[b][axis]) * 0.5f;
+        velocities[a][axis] = shared_velocity;
+        velocities[b][axis] = shared_velocity;
+    }
+    return true;
+}
+
+EntitySystem::EntitySystem(World& world, const float cell_size) : world(world), cellSize(cell_size)
+{
+    assert(cellSize > 0.0f);
+}
+
+EntitySystem::EntityId EntitySystem::createEntity(
+    const glm::vec3& pos,
+    const glm::vec3& hitbox_min,
+    const glm::vec3& hitbox_max,
+    const uint8_t entity_flags)
+{
+    EntityId id;
+    if (freeIds.empty())
+    {
+        id = static_cast<EntityId>(idToIndex.size());
+        idToIndex.push_back(0);
+    }
+    else
+    {
+        id = freeIds.back();
+        freeIds.pop_back();
+    }
+    idToIndex[id] = static_cast<uint32_t>(size());
+
+    positions.push_back(pos);
+    velocities.emplace_back(0.0f);
+    hitboxMins.push_back(hitbox_min);
+    hitboxMaxs.push_back(hitbox_max);
+    flags.push_back(entity_flags & ~ON_FLOOR);
+    ids.push_back(id);
+
+    return id;
+}
+
+void EntitySystem::destroyEntity(const EntityId id)
+{
+    if (!isAlive(id))
+    {
+        return;
+    }
+
+    // Move the last entity into the removed entity's slot to keep the components dense.
+    const uint32_t index = idToIndex[id];
+    const uint32_t last = static_cast<uint32_t>(size() - 1);
+    positions[index] = positions[last];
+    velocities[index] = velocities[last];
+    hitboxMins[index] = hitboxMins[last];
+    hitboxMaxs[index] = hitboxMaxs[last];
+    flags[index] = flags[last];
+    ids[index] = ids[last];
+    idToIndex[ids[index]] = index;
+
+    positions.pop_back();
+    velocities.pop_back();
+    hitboxMins.pop_back();
+    hitboxMaxs.pop_back();
+    flags.pop_back();
+    ids.pop_back();
+
+    idToIndex[id] = INVALID_ENTITY;
+    freeIds.push_back(id);
+}
+
+bool EntitySystem::isAlive(const EntityId id) const
+{
+    return (id < idToIndex.size()) && (idToIndex[id] != INVALID_ENTITY);
+}
+
+void EntitySystem::tick(const float dt)
+{
+    const auto start_time = std::chrono::steady_clock::now();
+
+    contacts.clear();
+
+    const size_t num_entities = size();
+    if (num_entities == 0)
+    {
+        lastTickDuration = {};
+        return;
+    }
+
+    // Entities only read the terrain and write their own components, so they can move independently. Run ahead of
+    // chunk work since the tick is waited on.
+    BS::priority_thread_pool& thread_pool = world.getThreadPool();
+    const size_t num_tasks = (num_entities + ENTITIES_PER_TASK - 1) / ENTITIES_PER_TASK;
+    thread_pool
+        .submit_sequence(
+            size_t(0),
+            num_tasks,
+            [this, dt, num_entities](const size_t task) {
+                const size_t end = std::min((task + 1) * ENTITIES_PER_TASK, num_entities);
+                for (size_t i = task * ENTITIES_PER_TASK; i < end; ++i)
+                {
+                    moveEntity(i, dt);
+                }
+            },
+            BS::pr::highest)
+        .wait();
+
+    // Find overlapping pairs in parallel, then resolve them in a fixed order so the result doesn't depend on timing.
+    buildSpatialHash();
+
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> task_pairs(num_tasks);
+    thread_pool
+        .submit_sequence(
+            size_t(0),
+            num_tasks,
+            [this, num_entities, &task_pairs](const size_t task) {
+                const size_t end = std::min((task + 1) * ENTITIES_PER_TASK, num_entities);
+                for (size_t i = task * ENTITIES_PER_TASK; i < end; ++i)
+                {
+                    findContacts(i, task_pairs[task]);
+                }
+            },
+            BS::pr::highest)
+        .wait();
+
+    for (const auto& pairs : task_pairs)
+    {
+        for (const auto& [a, b] : pairs)
+        {
+            if (resolveContact(a, b))
+            {
+                contacts.emplace_back(ids[a], ids[b]);
+            }
+        }
+    }
+
+    lastTickDuration =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+}
+
+std::optional<Aabb3d> EntitySystem::getTickBounds(const float dt) const
+{
+    if (size() == 0)
+    {
+        return std::nullopt;
+    }
+
+    glm::vec3 min_bounds = positions[0] + hitboxMins[0];
+    glm::vec3 max_bounds = positions[0] + hitboxMaxs[0];
+    glm::vec3 max_extents{0.0f};
+    float max_speed = 0.0f;
+    for (size_t i = 0; i < size(); ++i)
+    {
+        min_bounds = glm::min(min_bounds, positions[i] + hitboxMins[i]);
+        max_bounds = glm::max(max_bounds, positions[i] + hitboxMaxs[i]);
+        max_extents = glm::max(max_extents, hitboxMaxs[i] - hitboxMins[i]);
+        max_speed = std::max(max_speed, glm::length(velocities[i]));
+    }
+
+    // As far as the fastest entity can move after a tick of gravity, plus being pushed apart by another entity, which
+    // is less than the size of the largest hitbox.
+    const glm::vec3 margin = glm::vec3((max_speed + std::abs(world.getGravity()) * dt) * dt) + max_extents;
+    return Aabb3d(min_bounds - margin, max_bounds + margin);
+}
+
+void EntitySystem::queryAabb(const Aabb3d& aabb, std::vector<EntityId>& result) const
+{
+    // Uses the spatial hash from the last tick, so it doesn't see entities moved, created or destroyed since then.
+    if (bucketStarts.empty())
+    {
+        return;
+    }
+
+    const glm::ivec3 min_cell = getCell(aabb.getMinBounds() - maxHalfExtents);
+    const glm::ivec3 max_cell = getCell(aabb.getMaxBounds() + maxHalfExtents);
+    for (int z = min_cell.z; z <= max_cell.z; ++z)
+    {
+        for (int y = min_cell.y; y <= max_cell.y; ++y)
+        {
+            for (int x = min_cell.x; x <= max_cell.x; ++x)
+            {
+                const glm::ivec3 cell(x, y, z);
+                const size_t bucket = getBucketIndex(cell);
+                for (uint32_t k = bucketStarts[bucket]; k < bucketStarts[bucket + 1]; ++k)
+                {
+                    const uint32_t index = bucketEntries[k];
+                    if (index >= size() || cells[index] != cell)
+                    {
+                        continue;
+                    }
+
+                    if (CollisionHandler::shapeToShapeIntersect(aabb, getHitbox(index)))
+                    {
+                        result.push_back(ids[index]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+glm::vec3 EntitySystem::getPosition(const EntityId id) const
+{
+    assert(isAlive(id));
+    return positions[idToIndex[id]];
+}
+
+void EntitySystem::setPosition(const EntityId id, const glm::vec3& pos)
+{
+    assert(isAlive(id));
+    positions[idToIndex[id]] = pos;
+}
+
+glm::vec3 EntitySystem::getVelocity(const EntityId id) const
+{
+    assert(isAlive(id));
+    return velocities[idToIndex[id]];
+}
+
+void EntitySystem::setVelocity(const EntityId id, const glm::vec3& velocity)
+{
+    assert(isAlive(id));
+    velocities[idToIndex[id]] = velocity;
+}
+
+uint8_t EntitySystem::getFlags(const EntityId id) const
+{
+    assert(isAlive(id));
+    return flags[idToIndex[id]];
+}
+
+size_t EntitySystem::size() const
+{
+    return positions.size();
+}
+
+const std::vector<std::pair<EntitySystem::EntityId, EntitySystem::EntityId>>& EntitySystem::getContacts() const
+{
+    return contacts;
+}
+
+std::chrono::microseconds EntitySystem::getLastTickDuration() const
+{
+    return lastTickDuration;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "world.hpp"
+
+#include "engine/physics/shapes/aabb.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Simulates simple moving entities (e.g. mobs and items) in bulk.
+// Components are stored as structure-of-arrays indexed by a dense index, so a tick walks contiguous memory; ids stay
+// stable while the dense indices are swapped around on removal.
+// Each tick integrates the entities against the terrain in parallel on the world's thread pool, then finds overlapping
+// entities through a uniform spatial hash and pushes them apart.
+class EntitySystem
+{
+  public:
+    using EntityId = uint32_t;
+    static constexpr EntityId INVALID_ENTITY = UINT32_MAX;
+
+    enum Flags : uint8_t
+    {
+        NONE = 0,
+        HAS_GRAVITY = 1 << 0,
+        COLLIDES_WITH_TERRAIN = 1 << 1,
+        COLLIDES_WITH_ENTITIES = 1 << 2,
+        ON_FLOOR = 1 << 3, // Set by the simulation.
+    };
+    static constexpr uint8_t DEFAULT_FLAGS = HAS_GRAVITY | COLLIDES_WITH_TERRAIN | COLLIDES_WITH_ENTITIES;
+
+  private:
+    static constexpr float EPSILON = 0.0001f;
+    static constexpr size_t ENTITIES_PER_TASK = 1024;
+    static constexpr size_t NUM_HASH_BUCKETS = 1 << 14; // Must be a power of 2.
+    static constexpr unsigned MAX_COLLISION_ITERATIONS = 3;
+
+    World& world;
+    float cellSize; // In blocks; works best around the size of a typical entity.
+
+    // Components; indexed by dense index.
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> velocities;
+    std::vector<glm::vec3> hitboxMins; // Relative to the position.
+    std::vector<glm::vec3> hitboxMaxs; // Relative to the position.
+    std::vector<uint8_t> flags;
+    std::vector<EntityId> ids;
+
+    // Maps an id to its dense index; removed ids are recycled.
+    std::vector<uint32_t> idToIndex;
+    std::vector<EntityId> freeIds;
+
+    // Spatial hash rebuilt every tick: entities sorted by bucket, where `bucketStarts[b]` to `bucketStarts[b + 1]` is
+    // the range of dense indices in `bucketEntries` for bucket `b`. Each entity is stored once, in the cell containing
+    // its hitbox's center.
+    std::vector<glm::ivec3> cells;
+    std::vector<uint32_t> bucketStarts;
+    std::vector<uint32_t> bucketEntries;
+    glm::vec3 maxHalfExtents{0.0f}; // Largest hitbox half size of the entities in the hash.
+
+    std::vector<std::pair<EntityId, EntityId>> contacts;
+    std::chrono::microseconds lastTickDuration{0};
+
+    Aabb3d getHitbox(const size_t index) const;
+    glm::ivec3 getCell(const glm::vec3& pos) const;
+    size_t getBucketIndex(const glm::ivec3& cell) const;
+
+    void moveEntity(const size_t index, const float dt);
+    void buildSpatialHash();
+    void findContacts(const size_t index, std::vector<std::pair<uint32_t, uint32_t>>& pairs) const;
+    void pushEntity(const uint32_t index, const glm::vec3& displacement);
+    bool resolveContact(const uint32_t a, const uint32_t b); // Returns false if they no longer overlap.
+
+  public:
+    EntitySystem(World& world, const float cell_size = 2.0f);
+
+    EntityId createEntity(
+        const glm::vec3& pos,
+        const glm::vec3& hitbox_min,
+        const glm::vec3& hitbox_max,
+        const uint8_t entity_flags = DEFAULT_FLAGS);
+    void destroyEntity(const EntityId id);
+    bool isAlive(const EntityId id) const;
+
+    void tick(const float dt);
+    std::optional<Aabb3d> getTickBounds(const float dt) const; // Of the terrain the next tick can collide with.
+
+    void queryAabb(const Aabb3d& aabb, std::vector<EntityId>& result) const;
+
+    glm::vec3 getPosition(const EntityId id) const;
+    void setPosition(const EntityId id, const glm::vec3& pos);
+    glm::vec3 getVelocity(const EntityId id) const;
+    void setVelocity(const EntityId id, const glm::vec3& velocity);
+    uint8_t getFlags(const EntityId id) const;
+
+    size_t size() const;
+    // Pairs that overlapped and were pushed apart in the last tick.
+    const std::vector<std::pair<EntityId, EntityId>>& getContacts() const;
+    std::chrono::microseconds getLastTickDuration() const;
+};
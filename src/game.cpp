@@ -1,9 +1,18 @@
 #include "game.hpp"
+#include "engine/memory-tracking.hpp"
+#include "engine/metrics.hpp"
+#include "engine/profiler.hpp"
 #include "utility.hpp"
 #include "world.hpp"
 
+#include <glm/gtc/matrix_inverse.hpp>
+
 #include <chrono>
+#include <filesystem>
+#include <iomanip>
 #include <iostream>
+#include <string>
+#include <vector>
 
 struct LightingInfo
 {
@@ -12,10 +21,55 @@ struct LightingInfo
     alignas(16) glm::vec3 viewPos;
 };
 
+namespace
+{
+
+VmcMetrics::Counter& frames_counter = VmcMetrics::getCounter("frames");
+VmcMetrics::Counter& chunks_uploaded_counter = VmcMetrics::getCounter("chunks_uploaded");
+VmcMetrics::Counter& chunks_unloaded_counter = VmcMetrics::getCounter("chunks_unloaded");
+
+// Host bytes per subsystem and VMA's view of every device memory heap.
+void publishMemoryMetrics(const Renderer& renderer)
+{
+    VmcMemory::publishMetrics();
+
+    struct HeapGauges
+    {
+        VmcMetrics::Gauge& usage;
+        VmcMetrics::Gauge& budget;
+        VmcMetrics::Gauge& allocationBytes;
+        VmcMetrics::Gauge& numAllocations;
+    };
+    static std::vector<HeapGauges> heap_gauges;
+
+    const std::vector<VmaBudget> budgets = renderer.getDeviceMemoryBudgets();
+    for (size_t i = heap_gauges.size(); i < budgets.size(); ++i)
+    {
+        const std::string prefix = "memory.device_heap" + std::to_string(i);
+        heap_gauges.push_back({
+            VmcMetrics::getGauge(prefix + "_usage_bytes"),
+            VmcMetrics::getGauge(prefix + "_budget_bytes"),
+            VmcMetrics::getGauge(prefix + "_allocation_bytes"),
+            VmcMetrics::getGauge(prefix + "_allocations"),
+        });
+    }
+    for (size_t i = 0; i < budgets.size(); ++i)
+    {
+        heap_gauges[i].usage.set(static_cast<double>(budgets[i].usage));
+        heap_gauges[i].budget.set(static_cast<double>(budgets[i].budget));
+        heap_gauges[i].allocationBytes.set(static_cast<double>(budgets[i].statistics.allocationBytes));
+        heap_gauges[i].numAllocations.set(static_cast<double>(budgets[i].statistics.allocationCount));
+    }
+}
+
+} // namespace
+
 void Game::loadChunkModel(const Chunk& chunk)
 {
+    VMC_PROFILE_ZONE("Game::loadChunkModel");
+
     const ChunkCenter cc = chunk.getCenter();
-    const Model& chunk_model = chunk.getModel();
+    const Model& chunk_model = chunk.getMesh();
 
     const auto& chunk_vertices = chunk_model.getVertices();
     const auto& chunk_indices = chunk_model.getIndices();
@@ -34,6 +88,7 @@ void Game::loadChunkModel(const Chunk& chunk)
         return;
     }
 
+    chunks_uploaded_counter.add();
     if (chunkToVertexBufferId.contains(cc)) // Chunk already present, so update it.
     {
         const unsigned id = chunkToVertexBufferId[cc];
@@ -96,15 +151,99 @@ void Game::unloadChunkModel(const Chunk& chunk)
     renderer.removeVertexBuffer(id);
     chunkToVertexBufferId.erase(cc);
     reusableIds.push_back(id);
+    chunks_unloaded_counter.add();
+}
+
+bool Game::isInputDeterministic() const
+{
+    return pInputRecorder != nullptr || pInputReplay != nullptr;
+}
+
+std::optional<InputState> Game::getTickInput()
+{
+    std::optional<InputState> input;
+    if (pInputReplay != nullptr)
+    {
+        input = pInputReplay->next();
+        if (!input.has_value())
+        {
+            isReplayFinished = true;
+            return std::nullopt;
+        }
+    }
+    else
+    {
+        input = inputSampler.sample();
+    }
+
+    if (pInputRecorder != nullptr)
+    {
+        pInputRecorder->record(input.value());
+    }
+    return input;
+}
+
+Game::Game(const Options& options)
+{
+    if (options.chunkCachePath.has_value() && !world.enableChunkCache(options.chunkCachePath.value()))
+    {
+        std::cerr << "Failed to open chunk cache " << options.chunkCachePath.value()
+                  << "; chunks will be generated without it." << std::endl;
+    }
+
+    if (options.replayPath.has_value())
+    {
+        pInputReplay = std::make_unique<InputReplay>(options.replayPath.value());
+
+        const InputRecordingHeader& header = pInputReplay->getHeader();
+        if (header.worldSeed != WORLD_SEED || header.ticksPerSecond != TICKS_PER_SECOND)
+        {
+            throw std::runtime_error("input recording was made with a different world seed or tick rate!");
+        }
+    }
+
+    if (options.recordPath.has_value())
+    {
+        pInputRecorder = std::make_unique<InputRecorder>(
+            options.recordPath.value(),
+            InputRecordingHeader{WORLD_SEED, TICKS_PER_SECOND});
+    }
 }
 
 void Game::run()
 {
+    VMC_PROFILE_THREAD("Main");
+
     Texture* block_texture_ptr = renderer.createTexture(VmcUtility::getAssetPath("textures/cube_texture.jpg").string());
 
     world.addChunkLoadedCallback([this](const Chunk& chunk) { loadChunkModel(chunk); });
     world.addChunkUnloadedCallback([this](const Chunk& chunk) { unloadChunkModel(chunk); });
+    world.setVerticalRadius(DEFAULT_PLAYER_VERTICAL_RENDER_DISTANCE);
     world.init(DEFAULT_PLAYER_POS, DEFAULT_PLAYER_RENDER_DISTANCE);
+    simulation.addTickCallback([this](const float dt) {
+        if (isInputDeterministic())
+        {
+            world.waitForChunks(player.getTickBounds(dt));
+        }
+
+        const std::optional<InputState> input = getTickInput();
+        if (input.has_value())
+        {
+            player.tick(dt, input.value());
+        }
+    });
+    simulation.addTickCallback([this](const float dt) {
+        if (isInputDeterministic())
+        {
+            const std::optional<Aabb3d> bounds = entities.getTickBounds(dt);
+            if (bounds.has_value())
+            {
+                world.waitForChunks(bounds.value());
+            }
+        }
+
+        entities.tick(dt);
+    });
     std::cout << "Number of vertex buffers in use = " << chunkToVertexBufferId.size() << std::endl;
 
     const unsigned ubo_idx_transforms =
@@ -123,42 +262,133 @@ void Game::run()
     renderer.createGraphicsPipeline();
     renderer.createDescriptorSets();
 
+#if defined(VMC_ENABLE_PROFILING)
+    // Dump the most recent zones of every thread on demand.
+    window.addKeyCallback([](const int key, const int scancode, const int action, const int mods) {
+        if (key == GLFW_KEY_F3 && action == GLFW_PRESS)
+        {
+            const std::string path = "trace.json";
+            if (VmcProfiler::writeChromeTrace(path))
+            {
+                std::cout << "\nWrote profiler trace to " << std::filesystem::absolute(path) << std::endl;
+            }
+            else
+            {
+                std::cerr << "\nFailed to write profiler trace to " << path << std::endl;
+            }
+        }
+    });
+#endif
+
+    VmcMetrics::SnapshotWriter metrics_writer(METRICS_PATH, METRICS_INTERVAL);
+    if (!metrics_writer.isOpen())
+    {
+        std::cerr << "Failed to open " << METRICS_PATH << "; metrics won't be recorded." << std::endl;
+    }
+
+    uint64_t ubo_camera_version = UINT64_MAX;
+    int num_stale_ubo_frames = 0;
+
     std::chrono::steady_clock::time_point last_frame_time = std::chrono::steady_clock::now();
-    double accum_time = 0.0;
-    while (!window.shouldClose())
+    const auto start_time = std::chrono::steady_clock::now();
+    while (!window.shouldClose() && !isReplayFinished)
     {
-        window.pollEvents();
+        VMC_PROFILE_ZONE("Frame");
+        frameStats.beginFrame();
+
+        {
+            const FrameStats::ScopedPhase phase(frameStats, FrameStats::Phase::INPUT);
+            window.pollEvents();
+        }
 
         // TODO: game logic here
         std::chrono::steady_clock::time_point curr_frame_time = std::chrono::steady_clock::now();
         std::chrono::duration<double> delta_time = curr_frame_time - last_frame_time;
         last_frame_time = curr_frame_time;
-        accum_time += delta_time.count();
-        if (accum_time >= 0.3)
+
+        frames_counter.add();
+        publishMemoryMetrics(renderer);
+        metrics_writer.update();
+
         {
-            accum_time = 0.0;
-            double fps = 1.0 / delta_time.count();
-            std::cout << "\rFPS: " << static_cast<int>(fps) << "     ";
+            VMC_PROFILE_ZONE("Simulation");
+            const FrameStats::ScopedPhase phase(frameStats, FrameStats::Phase::PLAYER_UPDATE);
+            simulation.advance((pInputReplay != nullptr) ? 1.0 / TICKS_PER_SECOND : delta_time.count());
+            if (!isInputDeterministic())
+            {
+                // Looking around is per frame so it is as responsive as the frame rate allows.
+                double cursor_x = 0.0, cursor_y = 0.0;
+                window.getCursorPosition(cursor_x, cursor_y);
+                player.look(cursor_x, cursor_y, window.getInputMode(GLFW_CURSOR) == GLFW_CURSOR_DISABLED);
+            }
+            player.update(simulation.getAlpha());
         }
 
         // Update uniforms.
-        Model::UniformBufferObject ubo{};
-        ubo.model = glm::identity<glm::mat4>();
-        ubo.view = player.getCamera().viewMatrix();
-        ubo.proj = player.getCamera().projMatrix();
-        ubo.proj[1][1] *= -1;
-        renderer.updateUniformBuffer(ubo_idx_transforms, &ubo, sizeof(ubo));
+        // This comes after the simulation moved the camera so that the transforms and the culling below use the same
+        // view; otherwise chunks entering the screen would be drawn one frame late. Every frame in flight has its own
+        // copy of the transforms, so they are written for that many frames after the camera changes and skipped after
+        // that.
+        const Camera& camera = player.getCamera();
+        if (camera.getVersion() != ubo_camera_version)
+        {
+            ubo_camera_version = camera.getVersion();
+            num_stale_ubo_frames = MAX_FRAMES_IN_FLIGHT;
+        }
+        if (num_stale_ubo_frames > 0)
+        {
+            VMC_PROFILE_ZONE("Update transforms");
+
+            Model::UniformBufferObject ubo{};
+            ubo.model = glm::identity<glm::mat4>();
+            ubo.view = camera.viewMatrix();
+            ubo.proj = camera.projMatrix();
+            ubo.proj[1][1] *= -1;
+            ubo.viewProj = ubo.proj * ubo.view;
+            ubo.normal = glm::inverseTranspose(ubo.model);
+            renderer.updateUniformBuffer(ubo_idx_transforms, &ubo, sizeof(ubo));
+            --num_stale_ubo_frames;
+        }
 
         ubo_lighting.viewPos = player.getPosition();
         renderer.updateUniformBuffer(ubo_idx_light_info, &ubo_lighting, sizeof(ubo_lighting));
 
-        player.update(delta_time.count());
-        world.draw(player.getPosition(), player.getRenderDistance(), player.getCamera().getFrustum());
+        {
+            const FrameStats::ScopedPhase phase(frameStats, FrameStats::Phase::WORLD_DRAW);
+            world.remeshDirtyChunks(REMESH_BUDGET);
+            world.draw(camera.getFrustum());
+        }
 
         {
             std::lock_guard<std::mutex> lock(updateMutex);
             renderer.drawFrame();
         }
+        const Renderer::FrameTimings& render_timings = renderer.getLastFrameTimings();
+        frameStats.addPhaseTime(FrameStats::Phase::RECORD, render_timings.record);
+        frameStats.addPhaseTime(FrameStats::Phase::SUBMIT, render_timings.submit);
+        frameStats.addPhaseTime(FrameStats::Phase::PRESENT_WAIT, render_timings.presentWait);
+
+        if (frameStats.endFrame())
+        {
+            const FrameStats::Summary& summary = frameStats.getSummary();
+            std::cout << std::fixed << std::setprecision(1) << "\rFrame time: p50 " << summary.p50
+                      << " ms, p95 " << summary.p95 << " ms, p99 " << summary.p99 << " ms, max " << summary.max
+                      << " ms     " << std::flush;
+        }
+    }
+
+    metrics_writer.write(); // The last partial interval.
+
+    if (pInputReplay != nullptr)
+    {
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+        std::cout << "\nReplayed " << pInputReplay->getNumTicks() << " ticks in " << elapsed.count()
+                  << " s; world blocks hash " << std::hex << world.getBlocksHash() << std::dec << "." << std::endl;
+    }
+    if (pInputRecorder != nullptr)
+    {
+        std::cout << "\nRecorded " << pInputRecorder->getNumTicks() << " ticks; world blocks hash " << std::hex
+                  << world.getBlocksHash() << std::dec << "." << std::endl;
     }
 
     delete block_texture_ptr;
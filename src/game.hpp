@@ -1,30 +1,69 @@
 #pragma once
 
+#include "engine/fixed-timestep.hpp"
+#include "engine/frame-stats.hpp"
+#include "engine/input-recording.hpp"
+#include "engine/input.hpp"
 #include "engine/renderer/renderer.hpp"
+#include "entity-system.hpp"
 #include "player.hpp"
 
+#include <chrono>
+#include <filesystem>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <stack>
+#include <string>
 #include <unordered_map>
 
 class Game
 {
+  public:
+    struct Options
+    {
+        std::optional<std::filesystem::path> recordPath; // Write the input of every tick to this file.
+        std::optional<std::filesystem::path> replayPath; // Read the input of every tick from this file instead.
+        std::optional<std::filesystem::path> chunkCachePath; // Cache generated chunks in this directory.
+    };
+
   private:
     std::mutex updateMutex;
 
+    static constexpr unsigned WORLD_SEED = 727;
     static constexpr int CHUNK_SIZE = 16;
     static constexpr int MAX_NUM_BLOCKS_IN_CHUNK = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
     static constexpr glm::vec3 DEFAULT_PLAYER_POS{0.0f, 2.0f, 0.0f};
     static constexpr int DEFAULT_PLAYER_RENDER_DISTANCE = 4;
+    static constexpr unsigned DEFAULT_PLAYER_VERTICAL_RENDER_DISTANCE = 2; // Most of the terrain is near eye level.
+    static constexpr std::chrono::microseconds REMESH_BUDGET{2000}; // Per frame.
+    static constexpr double TICKS_PER_SECOND = 60.0;
+    static constexpr unsigned MAX_TICKS_PER_FRAME = 5;
+    static inline const std::string METRICS_PATH = "metrics.csv";
+    static constexpr std::chrono::milliseconds METRICS_INTERVAL{1000};
+    static constexpr std::chrono::duration<double, std::milli> HITCH_THRESHOLD{33.3}; // Two frames at 60 Hz.
 
     std::vector<unsigned> reusableIds; // TODO: std::stack doesn't like being down here.
     std::unordered_map<ChunkCenter, unsigned> chunkToVertexBufferId;
 
     Window window;
     Renderer renderer{window};
-    World world{727, CHUNK_SIZE, static_cast<unsigned>(std::thread::hardware_concurrency() * 0.25)};
+    World world{WORLD_SEED, CHUNK_SIZE, static_cast<unsigned>(std::thread::hardware_concurrency() * 0.25)};
+    EntitySystem entities{world};
     Player player{window, world, DEFAULT_PLAYER_POS, 4.0f, DEFAULT_PLAYER_RENDER_DISTANCE};
+    FixedTimestep simulation{TICKS_PER_SECOND, MAX_TICKS_PER_FRAME};
+    FrameStats frameStats{HITCH_THRESHOLD};
+
+    // Ticks take their input from the window unless a recording is replayed; either way it can also be recorded.
+    // While recording or replaying, every tick first waits for the chunks it can touch to be generated and the view
+    // only turns in ticks, so that what the player collides with and edits doesn't depend on how fast chunks were
+    // generated or on the frame rate; the rest keep loading in the background as they do in live play. A replay also
+    // runs exactly one tick per frame.
+    InputSampler inputSampler{window};
+    std::unique_ptr<InputRecorder> pInputRecorder;
+    std::unique_ptr<InputReplay> pInputReplay;
+    bool isReplayFinished = false;
 
     std::queue<Chunk*> chunksToLoad;
     std::queue<Chunk*> chunksToUnload;
@@ -32,6 +71,11 @@ class Game
     void loadChunkModel(const Chunk& chunk);
     void unloadChunkModel(const Chunk& chunk);
 
+    bool isInputDeterministic() const; // Recording or replaying.
+    std::optional<InputState> getTickInput();
+
   public:
+    explicit Game(const Options& options);
+
     void run();
 };
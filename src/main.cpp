@@ -1,13 +1,57 @@
 #include "game.hpp"
 
 #include <iostream>
+#include <string>
 
-int main()
+namespace
 {
-    Game game;
+
+bool parseOptions(const int argc, char* argv[], Game::Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << arg << "." << std::endl;
+            return false;
+        }
+
+        if (arg == "--record")
+        {
+            options.recordPath = argv[++i];
+        }
+        else if (arg == "--replay")
+        {
+            options.replayPath = argv[++i];
+        }
+        else if (arg == "--chunk-cache")
+        {
+            options.chunkCachePath = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Unknown option " << arg << "." << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Game::Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--record FILE] [--replay FILE] [--chunk-cache DIR]" << std::endl;
+        return EXIT_FAILURE;
+    }
 
     try
     {
+        Game game(options);
         game.run();
     }
     catch (const std::exception& e)
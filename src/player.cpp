@@ -2,31 +2,23 @@
 
 #include <glm/gtx/string_cast.hpp>
 
-constexpr float EPSILON = 0.0001f;
-
-void Player::updatePosition()
-{
-    const glm::vec3 displacement = position - prevPosition;
-    camera.translate(displacement);
-    reach.setOrigin(camera.getEye());
-    hitbox.translate(displacement);
-}
+#include <cmath>
 
-int Player::getKeyState(const int key) const
-{
-    return window.getKeyboardKey(key);
-}
+constexpr float EPSILON = 0.0001f;
 
-bool Player::isKeyPressed(const int key_state) const
+void Player::updatePosition(const glm::vec3& render_pos)
 {
-    return getKeyState(key_state) == GLFW_PRESS;
+    // Only the view follows the interpolated position; the hitbox and reach are moved with the simulated position in
+    // `tick`.
+    camera.translate(render_pos - renderPosition);
+    renderPosition = render_pos;
 }
 
-void Player::pollKeyboardControls(const double delta)
+void Player::pollKeyboardControls(const double delta, const InputState& input)
 {
     float adj_speed = speed;
     float dt = static_cast<float>(delta);
-    if (isKeyPressed(GLFW_KEY_LEFT_CONTROL))
+    if (input.isKeyDown(GLFW_KEY_LEFT_CONTROL))
     {
         adj_speed *= DEFAULT_SPRINT_MULTIPLIER;
     }
@@ -47,27 +39,27 @@ void Player::pollKeyboardControls(const double delta)
     {
         new_velocity = {};
         adj_speed *= 2.0f;
-        if (isKeyPressed(GLFW_KEY_W))
+        if (input.isKeyDown(GLFW_KEY_W))
         {
             new_velocity += forward * adj_speed;
         }
-        if (isKeyPressed(GLFW_KEY_S))
+        if (input.isKeyDown(GLFW_KEY_S))
         {
             new_velocity += -forward * adj_speed;
         }
-        if (isKeyPressed(GLFW_KEY_A))
+        if (input.isKeyDown(GLFW_KEY_A))
         {
             new_velocity += -right * adj_speed;
         }
-        if (isKeyPressed(GLFW_KEY_D))
+        if (input.isKeyDown(GLFW_KEY_D))
         {
             new_velocity += right * adj_speed;
         }
-        if (isKeyPressed(GLFW_KEY_LEFT_SHIFT))
+        if (input.isKeyDown(GLFW_KEY_LEFT_SHIFT))
         {
             new_velocity += -up * adj_speed;
         }
-        if (isKeyPressed(GLFW_KEY_SPACE))
+        if (input.isKeyDown(GLFW_KEY_SPACE))
         {
             new_velocity += up * adj_speed;
         }
@@ -77,19 +69,19 @@ void Player::pollKeyboardControls(const double delta)
         new_velocity.x = 0.0f;
         new_velocity.z = 0.0f;
 
-        if (isKeyPressed(GLFW_KEY_W))
+        if (input.isKeyDown(GLFW_KEY_W))
         {
             new_velocity += forward * adj_speed;
         }
-        if (isKeyPressed(GLFW_KEY_S))
+        if (input.isKeyDown(GLFW_KEY_S))
         {
             new_velocity += -forward * adj_speed;
         }
-        if (isKeyPressed(GLFW_KEY_A))
+        if (input.isKeyDown(GLFW_KEY_A))
         {
             new_velocity += -right * adj_speed;
         }
-        if (isKeyPressed(GLFW_KEY_D))
+        if (input.isKeyDown(GLFW_KEY_D))
         {
             new_velocity += right * adj_speed;
         }
@@ -97,10 +89,9 @@ void Player::pollKeyboardControls(const double delta)
         // Apply forces.
         new_velocity.y += world.getGravity() * 2.0f * dt;
 
-        constexpr float jump_force = 7.0f;
-        if (isOnFloor && isKeyPressed(GLFW_KEY_SPACE))
+        if (isOnFloor && input.isKeyDown(GLFW_KEY_SPACE))
         {
-            new_velocity += up * jump_force;
+            new_velocity += up * JUMP_FORCE;
         }
     }
 
@@ -121,8 +112,7 @@ void Player::pollKeyboardControls(const double delta)
             bool intersected = false;
             if (gameMode != GameMode::Creative)
             {
-                intersected =
-                    world.doesEntityIntersect(new_position, new_velocity, remaining_dt, new_hitbox, new_dt, &normal);
+                intersected = world.doesEntityIntersect(new_velocity, remaining_dt, new_hitbox, new_dt, &normal);
             }
 
             if (!intersected)
@@ -187,21 +177,6 @@ void Player::eventKeyboardControls(const int key, const int scancode, const int
                 window.setInputMode(GLFW_CURSOR, GLFW_CURSOR_DISABLED);
             }
         }
-
-        if (key == GLFW_KEY_F1)
-        {
-            switch (gameMode)
-            {
-            case GameMode::Creative: {
-                gameMode = GameMode::Survival;
-                break;
-            }
-            case GameMode::Survival: {
-                gameMode = GameMode::Creative;
-                break;
-            }
-            }
-        }
     }
 }
 
@@ -214,15 +189,15 @@ Player::Player(Window& window, World& world, const glm::vec3& pos, const float s
     : window(window), world(world),
       camera(
           window,
-          pos + glm::vec3(0.0f, DEFAULT_PLAYER_HEIGHT - 0.18f, 0.0f),
-          pos + glm::vec3(1.0f, DEFAULT_PLAYER_HEIGHT - 0.18f, 0.0f),
+          pos + EYE_OFFSET,
+          pos + EYE_OFFSET + glm::vec3(1.0f, 0.0f, 0.0f),
           glm::vec3(0.0f, 1.0f, 0.0f),
           glm::radians(70.0f),
           (static_cast<float>(Window::DEFAULT_WIDTH) / static_cast<float>(Window::DEFAULT_HEIGHT)),
           0.1f,
           1000.0f),
-      position(pos), prevPosition(pos), speed(speed), renderDistance(render_distance),
-      reach(pos + camera.getEye(), camera.getForward(), 0.0f, 2.0f),
+      position(pos), prevPosition(pos), renderPosition(pos), speed(speed), renderDistance(render_distance),
+      reach(pos + EYE_OFFSET, camera.getForward(), 0.0f, 2.0f),
       hitbox(pos + glm::vec3(-0.3f, 0.0f, -0.3f), pos + glm::vec3(0.3f, DEFAULT_PLAYER_HEIGHT, 0.3f)),
       chunkCenter(world.getPosToChunkCenter(getPosition()))
 {
@@ -233,47 +208,90 @@ Player::Player(Window& window, World& world, const glm::vec3& pos, const float s
         [this](int button, int action, int mods) { this->eventMouseControls(button, action, mods); });
 }
 
-void Player::update(const double delta)
+void Player::pollMouseControls(const InputState& input)
 {
-    prevPosition = position;
-
-    // Keyboard input.
-    pollKeyboardControls(delta);
-
-    // Mouse input.
-    double x = 0.0, y = 0.0;
-    window.getCursorPosition(x, y);
-    if (window.getInputMode(GLFW_CURSOR) == GLFW_CURSOR_DISABLED)
-    {
-        const float delta_x = (static_cast<float>(x) - cursorPrevX) * mouseSensitivity;
-        const float delta_y = -(static_cast<float>(y) - cursorPrevY) * mouseSensitivity;
-
-        if (delta_x != 0.0f || delta_y != 0.0f)
-        {
-            camera.rotate(delta_y, delta_x, 0.0f, true);
-            reach.setDirection(camera.getForward());
-        }
-    }
-    cursorPrevX = static_cast<float>(x);
-    cursorPrevY = static_cast<float>(y);
-
     glm::ivec3 face_entered{};
     std::optional<glm::vec3> block_pos = world.getReachableBlock(reach, &face_entered);
     if (block_pos.has_value())
     {
-        if (window.getMouseButtonState(GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS)
+        if (input.isMouseButtonDown(GLFW_MOUSE_BUTTON_RIGHT))
         {
             // TODO: handle block addition.
             world.addBlock(block_pos.value() + static_cast<glm::vec3>(face_entered));
         }
-        else if (window.getMouseButtonState(GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS)
+        else if (input.isMouseButtonDown(GLFW_MOUSE_BUTTON_LEFT))
         {
             // TODO: handle block deletion.
             world.removeBlock(block_pos.value());
         }
     }
+}
 
-    updatePosition();
+void Player::tick(const float dt, const InputState& input)
+{
+    prevPosition = position;
+
+    // Catch up to the cursor position of this tick; this is a no-op when looking around per frame already got there,
+    // but it's what turns the camera while input is recorded or replayed.
+    look(input.cursorX, input.cursorY, input.isCursorDisabled);
+
+    if (input.wasKeyPressed(GLFW_KEY_F1))
+    {
+        switch (gameMode)
+        {
+        case GameMode::Creative: {
+            gameMode = GameMode::Survival;
+            break;
+        }
+        case GameMode::Survival: {
+            gameMode = GameMode::Creative;
+            break;
+        }
+        }
+    }
+
+    // Keyboard input.
+    pollKeyboardControls(dt, input);
+    hitbox.translate(position - prevPosition);
+
+    // Mouse buttons; block edits are part of the simulation so they happen at the same rate at any frame rate. The
+    // reach starts at the simulated eye rather than the interpolated camera so that which block is picked doesn't
+    // depend on the frame timing.
+    reach.setOrigin(position + EYE_OFFSET);
+    pollMouseControls(input);
+}
+
+Aabb3d Player::getTickBounds(const float dt) const
+{
+    // Moving at the fastest speed either game mode allows (flying at twice the sprint speed along every axis, or
+    // falling and jumping), then reaching out from anywhere along the way. An edited block can also change the chunk
+    // next to it, so the block beyond the reach counts too.
+    const float max_speed = glm::length(velocity) + 2.0f * speed * DEFAULT_SPRINT_MULTIPLIER * std::sqrt(3.0f) +
+                            JUMP_FORCE + std::abs(world.getGravity()) * 2.0f * dt;
+    const glm::vec3 margin(max_speed * dt + reach.getMax() + 1.0f);
+    return Aabb3d(hitbox.getMinBounds() - margin, hitbox.getMaxBounds() + margin);
+}
+
+void Player::look(const double cursor_x, const double cursor_y, const bool is_cursor_disabled)
+{
+    if (is_cursor_disabled)
+    {
+        const float delta_x = (static_cast<float>(cursor_x) - cursorPrevX) * mouseSensitivity;
+        const float delta_y = -(static_cast<float>(cursor_y) - cursorPrevY) * mouseSensitivity;
+
+        if (delta_x != 0.0f || delta_y != 0.0f)
+        {
+            camera.rotate(delta_y, delta_x, 0.0f, true);
+            reach.setDirection(camera.getForward());
+        }
+    }
+    cursorPrevX = static_cast<float>(cursor_x);
+    cursorPrevY = static_cast<float>(cursor_y);
+}
+
+void Player::update(const float alpha)
+{
+    updatePosition(glm::mix(prevPosition, position, alpha));
 
     // std::cout << "@pos " << glm::to_string(position) << "     "
     //           << "\n@vel " << glm::to_string(velocity) << "     "
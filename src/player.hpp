@@ -2,6 +2,7 @@
 
 #include "block.hpp"
 #include "engine/camera.hpp"
+#include "engine/input.hpp"
 #include "engine/physics/ray/ray.hpp"
 #include "engine/physics/shapes/aabb.hpp"
 #include "engine/renderer/window.hpp"
@@ -19,6 +20,8 @@ class Player
   private:
     static constexpr float DEFAULT_SPRINT_MULTIPLIER = 3.0f;
     static constexpr float DEFAULT_PLAYER_HEIGHT = 1.8f;
+    static constexpr float JUMP_FORCE = 7.0f;
+    static constexpr glm::vec3 EYE_OFFSET{0.0f, DEFAULT_PLAYER_HEIGHT - 0.18f, 0.0f}; // From the feet.
 
     Window& window;
 
@@ -32,25 +35,24 @@ class Player
     GameMode gameMode = GameMode::Creative;
 
     // Player attributes.
-    glm::vec3 position;
-    glm::vec3 prevPosition;
-    glm::vec3 velocity;
+    glm::vec3 position;       // Simulated position; changes once per tick.
+    glm::vec3 prevPosition;   // Simulated position before the last tick.
+    glm::vec3 renderPosition; // Interpolated between the last two ticks; followed by the camera.
+    glm::vec3 velocity{0.0f};
     float speed;
     unsigned renderDistance;
 
-    bool isOnFloor;
+    bool isOnFloor = false;
 
     // Mouse variables.
     float mouseSensitivity = 0.08f;
     float cursorPrevX = 0.0f;
     float cursorPrevY = 0.0f;
 
-    void updatePosition();
+    void updatePosition(const glm::vec3& render_pos);
 
-    int getKeyState(const int key) const;
-    bool isKeyPressed(const int key_state) const;
-
-    void pollKeyboardControls(const double delta);
+    void pollKeyboardControls(const double delta, const InputState& input);
+    void pollMouseControls(const InputState& input);
     void eventKeyboardControls(const int key, const int scancode, const int action, const int mods);
 
     void eventMouseControls(const int button, const int action, const int mods);
@@ -60,7 +62,10 @@ class Player
 
     Player(Window& window, World& world, const glm::vec3& pos, const float speed, const unsigned render_distance);
 
-    void update(const double delta);
+    void tick(const float dt, const InputState& input);
+    Aabb3d getTickBounds(const float dt) const; // Everything the next tick can collide with, pick or edit.
+    void look(const double cursor_x, const double cursor_y, const bool is_cursor_disabled);
+    void update(const float alpha);
 
     const Camera& getCamera() const;
     const glm::vec3 getPosition() const;
@@ -1,7 +1,42 @@
 #include "world.hpp"
 
+#include "engine/metrics.hpp"
+#include "engine/physics/collision-handler.hpp"
+#include "engine/profiler.hpp"
+
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <tuple>
+
+namespace
+{
+
+VmcMetrics::Counter& chunks_generated_counter = VmcMetrics::getCounter("chunks_generated");
+VmcMetrics::Counter& chunks_meshed_counter = VmcMetrics::getCounter("chunks_meshed");
+VmcMetrics::Counter& remesh_requested_counter = VmcMetrics::getCounter("remesh_requested");
+VmcMetrics::Counter& remesh_coalesced_counter = VmcMetrics::getCounter("remesh_coalesced");
+VmcMetrics::Counter& remesh_processed_counter = VmcMetrics::getCounter("remesh_processed");
+VmcMetrics::Gauge& visible_chunks_gauge = VmcMetrics::getGauge("visible_chunks");
+VmcMetrics::Gauge& queued_tasks_gauge = VmcMetrics::getGauge("thread_pool_queued_tasks");
+VmcMetrics::Histogram& chunk_edit_lock_wait_histogram = VmcMetrics::getHistogram(
+    "chunk_edit_lock_wait_us",
+    VmcMetrics::Histogram::makeExponentialBounds(1.0, 2.0, 18)); // Up to ~131 ms.
+
+template <typename Lock>
+void lockChunkEdits(Lock& lock)
+{
+    VMC_PROFILE_ZONE("Wait for chunkEditMutex");
+
+    const auto start_time = std::chrono::steady_clock::now();
+    lock.lock();
+    const std::chrono::duration<double, std::micro> wait_time = std::chrono::steady_clock::now() - start_time;
+    chunk_edit_lock_wait_histogram.record(wait_time.count());
+}
+
+} // namespace
 
 void World::runChunkLoadedCallbacks(const Chunk& chunk)
 {
@@ -19,11 +54,214 @@ void World::runChunkUnloadedCallbacks(const Chunk& chunk)
     }
 }
 
+void World::runActiveChunksChangedCallbacks(
+    const std::vector<ChunkCenter>& entered,
+    const std::vector<ChunkCenter>& exited)
+{
+    for (const auto& callback : activeChunksChangedCallbacks)
+    {
+        callback(entered, exited);
+    }
+}
+
 bool World::isChunkActive(const ChunkCenter& cc) const
 {
     return activeChunks.contains(cc) && chunks.contains(cc);
 }
 
+bool World::isOffsetInRange(const glm::ivec3& offset, const unsigned radius) const
+{
+    // Compare against `radius + 0.5` (doubled to stay in integers) so the chunks along the axes at exactly `radius` are
+    // kept while the corners of the enclosing cube are dropped.
+    const int r = static_cast<int>(radius);
+    const int diameter_sq = (2 * r + 1) * (2 * r + 1);
+
+    if (verticalRadius.has_value())
+    {
+        // Cylinder around the y-axis.
+        const int horizontal_dist_sq = 4 * (offset.x * offset.x + offset.z * offset.z);
+        return (horizontal_dist_sq <= diameter_sq) && (std::abs(offset.y) <= static_cast<int>(verticalRadius.value()));
+    }
+
+    // Sphere.
+    const int dist_sq = 4 * (offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+    return dist_sq <= diameter_sq;
+}
+
+const std::vector<glm::ivec3>& World::getChunkOffsets(const unsigned radius)
+{
+    if (!chunkOffsets.empty() && (chunkOffsetsRadius == radius))
+    {
+        return chunkOffsets;
+    }
+
+    chunkOffsets.clear();
+    chunkOffsetsRadius = radius;
+
+    // The offsets changed, so the active set can't be diffed against the old one.
+    activeCenter.reset();
+
+    // A cylinder can reach further up and down than the horizontal radius.
+    const int r = static_cast<int>(radius);
+    const int vertical_r = static_cast<int>(verticalRadius.value_or(radius));
+    for (int x = -r; x <= r; ++x)
+    {
+        for (int y = -vertical_r; y <= vertical_r; ++y)
+        {
+            for (int z = -r; z <= r; ++z)
+            {
+                const glm::ivec3 offset(x, y, z);
+                if (isOffsetInRange(offset, radius))
+                {
+                    chunkOffsets.push_back(offset);
+                }
+            }
+        }
+    }
+
+    // Nearest first; ties are broken by the components so the order is the same on every run.
+    std::sort(chunkOffsets.begin(), chunkOffsets.end(), [](const glm::ivec3& a, const glm::ivec3& b) {
+        const int a_dist_sq = a.x * a.x + a.y * a.y + a.z * a.z;
+        const int b_dist_sq = b.x * b.x + b.y * b.y + b.z * b.z;
+        if (a_dist_sq != b_dist_sq)
+        {
+            return a_dist_sq < b_dist_sq;
+        }
+        if (a.y != b.y)
+        {
+            return a.y < b.y;
+        }
+        if (a.x != b.x)
+        {
+            return a.x < b.x;
+        }
+        return a.z < b.z;
+    });
+
+    // Precompute the slabs that change when the center moves one chunk along each axis.
+    constexpr std::array<glm::ivec3, 6> directions = {
+        glm::ivec3(1, 0, 0),  // +x
+        glm::ivec3(0, 1, 0),  // +y
+        glm::ivec3(0, 0, 1),  // +z
+        glm::ivec3(-1, 0, 0), // -x
+        glm::ivec3(0, -1, 0), // -y
+        glm::ivec3(0, 0, -1), // -z
+    };
+    for (size_t i = 0; i < directions.size(); ++i)
+    {
+        enteringChunkOffsets[i].clear();
+        exitingChunkOffsets[i].clear();
+        for (const auto& offset : chunkOffsets)
+        {
+            // Relative to the old center, an offset from the new center is at `offset + direction`.
+            if (!isOffsetInRange(offset + directions[i], radius))
+            {
+                enteringChunkOffsets[i].push_back(offset);
+            }
+            // Relative to the new center, an offset from the old center is at `offset - direction`.
+            if (!isOffsetInRange(offset - directions[i], radius))
+            {
+                exitingChunkOffsets[i].push_back(offset);
+            }
+        }
+    }
+
+    return chunkOffsets;
+}
+
+ChunkCenter World::getOffsetChunkCenter(const ChunkCenter& cc, const glm::ivec3& offset) const
+{
+    return cc + glm::vec3(offset) * static_cast<float>(chunkSize);
+}
+
+glm::ivec3 World::getChunkCoord(const ChunkCenter& cc) const
+{
+    return glm::ivec3(glm::round(cc / static_cast<float>(chunkSize)));
+}
+
+void World::getActiveChunksDiff(
+    const ChunkCenter& new_cc,
+    const unsigned radius,
+    std::vector<ChunkCenter>& entered,
+    std::vector<ChunkCenter>& exited)
+{
+    const std::vector<glm::ivec3>& offsets = getChunkOffsets(radius);
+
+    // Nothing is active yet (or the offsets were rebuilt), so everything is entered and everything old is exited.
+    if (!activeCenter.has_value())
+    {
+        std::unordered_set<ChunkCenter> prev_active_chunks = std::move(activeChunks);
+        activeChunks.clear();
+        for (const auto& offset : offsets)
+        {
+            const ChunkCenter cc = getOffsetChunkCenter(new_cc, offset);
+            if (prev_active_chunks.erase(cc) == 0)
+            {
+                entered.push_back(cc);
+            }
+            activeChunks.emplace(cc);
+        }
+        exited.assign(prev_active_chunks.begin(), prev_active_chunks.end());
+        return;
+    }
+
+    const ChunkCenter old_cc = activeCenter.value();
+    const glm::ivec3 delta = glm::round((new_cc - old_cc) / static_cast<float>(chunkSize));
+    if (delta == glm::ivec3(0))
+    {
+        return;
+    }
+
+    // Crossing a single chunk boundary only needs the precomputed slabs.
+    const int manhattan_dist = std::abs(delta.x) + std::abs(delta.y) + std::abs(delta.z);
+    if (manhattan_dist == 1)
+    {
+        size_t axis = 0;
+        for (glm::length_t i = 0; i < 3; ++i)
+        {
+            if (delta[i] != 0)
+            {
+                axis = (delta[i] > 0) ? i : (i + 3);
+            }
+        }
+
+        entered.reserve(enteringChunkOffsets[axis].size());
+        for (const auto& offset : enteringChunkOffsets[axis])
+        {
+            entered.push_back(getOffsetChunkCenter(new_cc, offset));
+        }
+        exited.reserve(exitingChunkOffsets[axis].size());
+        for (const auto& offset : exitingChunkOffsets[axis])
+        {
+            exited.push_back(getOffsetChunkCenter(old_cc, offset));
+        }
+    }
+    else
+    {
+        // Otherwise (e.g. diagonal moves or teleports), find the difference arithmetically instead of hashing.
+        for (const auto& offset : offsets)
+        {
+            if (!isOffsetInRange(offset + delta, radius))
+            {
+                entered.push_back(getOffsetChunkCenter(new_cc, offset));
+            }
+            if (!isOffsetInRange(offset - delta, radius))
+            {
+                exited.push_back(getOffsetChunkCenter(old_cc, offset));
+            }
+        }
+    }
+
+    for (const auto& cc : exited)
+    {
+        activeChunks.erase(cc);
+    }
+    for (const auto& cc : entered)
+    {
+        activeChunks.emplace(cc);
+    }
+}
+
 std::array<Chunk*, 6> World::getNeighboringChunks(const ChunkCenter& cc) const
 {
     std::array<Chunk*, 6> neighboring_chunks{};
@@ -42,32 +280,148 @@ std::array<Chunk*, 6> World::getNeighboringChunks(const ChunkCenter& cc) const
         const glm::vec3 offset = offsets[i];
         const ChunkCenter neighbor_cc = getPosToChunkCenter(cc + offset);
 
-        if (chunks.contains(neighbor_cc))
-        {
-            neighboring_chunks[i] = chunks.at(neighbor_cc);
-        }
+        neighboring_chunks[i] = chunks.find(neighbor_cc);
     }
 
     return neighboring_chunks;
 }
 
+void World::meshChunkIfReady(Chunk* chunk)
+{
+    // Wait for every neighbor so the chunk is only meshed once with its final edge faces.
+    if (!chunk->hasAllNeighboringChunks())
+    {
+        return;
+    }
+
+    // Only one thread gets to schedule the mesh.
+    if (!chunk->advanceState(Chunk::State::GENERATED, Chunk::State::NEIGHBORS_READY))
+    {
+        return;
+    }
+
+    threadPool.detach_task([this, chunk]() { meshChunk(chunk); }, MESH_TASK_PRIORITY);
+}
+
+void World::meshChunk(Chunk* chunk)
+{
+    VMC_PROFILE_ZONE("World::meshChunk");
+
+    {
+        std::shared_lock<std::shared_mutex> lock(chunkEditMutex, std::defer_lock);
+        lockChunkEdits(lock);
+
+        const auto start_time = std::chrono::steady_clock::now();
+        chunk->updateMesh();
+        recordStageTime(stageTimings.meshed, start_time);
+
+        // Still under the lock so that any edit after `updateMesh()` read the blocks finds the chunk meshed and
+        // remeshes it; the main thread picks up meshed chunks and uploads them once they are visible.
+        chunk->setState(Chunk::State::MESHED);
+    }
+    chunks_meshed_counter.add();
+
+    std::lock_guard<std::mutex> lock(meshedChunksMutex);
+    meshedChunks.push_back(chunk);
+}
+
+bool World::remeshChunk(Chunk* chunk)
+{
+    // A worker may still be writing the mesh; the caller retries once it's done.
+    const Chunk::State state = chunk->getState();
+    if (state < Chunk::State::MESHED)
+    {
+        return false;
+    }
+
+    chunk->updateMesh();
+    updateChunkBounds(chunk);
+    if (state == Chunk::State::UPLOADED)
+    {
+        runChunkLoadedCallbacks(*chunk);
+    }
+    return true;
+}
+
+void World::releaseChunkMesh(Chunk* chunk)
+{
+    // Only the main thread moves a chunk on from `MESHED`, so no worker can be writing the mesh here. Going back to
+    // `GENERATED` has the chunk meshed again if it re-enters the range.
+    const Chunk::State state = chunk->getState();
+    if (state == Chunk::State::MESHED)
+    {
+        chunk->releaseMesh();
+        chunk->setState(Chunk::State::GENERATED);
+    }
+    else if (state != Chunk::State::GENERATED)
+    {
+        return; // Still uploaded, or a mesh is being built; both are released later.
+    }
+
+    // Without a mesh there is nothing to remesh, and any mesh built later reads the edited blocks.
+    dirtyChunks.erase(chunk->getCenter());
+}
+
+void World::markChunkDirty(const ChunkCenter& cc)
+{
+    ++remeshStats.requested;
+    remesh_requested_counter.add();
+    if (!dirtyChunks.emplace(cc).second)
+    {
+        ++remeshStats.coalesced;
+        remesh_coalesced_counter.add();
+        return;
+    }
+    dirtyChunksQueue.push_back(cc);
+}
+
+void World::recordStageTime(
+    std::vector<std::chrono::nanoseconds>& samples,
+    const std::chrono::steady_clock::time_point start_time)
+{
+    if (!areStageTimingsEnabled)
+    {
+        return;
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - start_time;
+
+    std::lock_guard<std::mutex> lock(stageTimingsMutex);
+    samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+}
+
+void World::updateChunkBounds(const Chunk* chunk)
+{
+    // The mesh bounds may only be read once the chunk is meshed since a worker thread writes them until then.
+    const ChunkCenter cc = chunk->getCenter();
+    if (chunk->getState() >= Chunk::State::MESHED && isChunkActive(cc) && chunk->getMeshBounds().has_value())
+    {
+        chunkBoundsTree.insert(getChunkCoord(cc), chunk->getMeshBounds().value());
+    }
+    else
+    {
+        chunkBoundsTree.erase(getChunkCoord(cc));
+    }
+}
+
 void World::editBlock(const glm::vec3 block_pos, const bool should_add)
 {
     const ChunkCenter cc = getPosToChunkCenter(block_pos);
 
+    // Ignore if the associated chunk is not active.
+    if (!isChunkActive(cc))
     {
-        std::shared_lock<std::shared_mutex> lock(chunksMutex);
+        return;
+    }
+    Chunk* chunk = chunks.find(cc);
 
-        // Ignore if the associated chunk is not active.
-        if (!isChunkActive(cc))
-        {
-            return;
-        }
+    {
+        std::lock_guard<std::shared_mutex> lock(chunkEditMutex);
 
         // Be ready to notify neighboring chunk if this block is being added on the edge because it may affect the
         // neighbor. Futhermore, if the neighbor is non-existent, do not add a block.
         std::vector<Chunk*> affected_neighbors;
-        if (chunks[cc]->isBlockOnEdge(block_pos))
+        if (chunk->isBlockOnEdge(block_pos))
         {
             // Get neighbors.
             auto neighbors = getNeighboringChunks(cc);
@@ -75,7 +429,7 @@ void World::editBlock(const glm::vec3 block_pos, const bool should_add)
             // Figure out which neighbor(s).
             for (size_t i = 0; i < neighbors.size(); ++i)
             {
-                if (chunks[cc]->isBlockOnEdge(block_pos, static_cast<Axis>(i)))
+                if (chunk->isBlockOnEdge(block_pos, static_cast<Axis>(i)))
                 {
                     // Cancel the addition if this necessary neighbor does not exist.
                     if (neighbors[i] == nullptr)
@@ -91,25 +445,29 @@ void World::editBlock(const glm::vec3 block_pos, const bool should_add)
         // Add/remove the block and notify neighbors as needed.
         if (should_add)
         {
-            chunks[cc]->addBlock(block_pos);
+            chunk->addBlock(block_pos);
         }
         else
         {
-            chunks[cc]->removeBlock(block_pos);
+            chunk->removeBlock(block_pos);
         }
-        runChunkLoadedCallbacks(*chunks[cc]);
+        markChunkDirty(cc);
         for (auto& neighbor : affected_neighbors)
         {
             if (neighbor != nullptr)
             {
-                runChunkLoadedCallbacks(*neighbor);
+                markChunkDirty(neighbor->getCenter());
             }
         }
     }
 }
 
 World::World(const unsigned seed, const int chunk_size, const unsigned num_threads)
-    : terrainHeightNoise(seed), seed(seed), chunkSize(chunk_size), threadPool(std::max(num_threads, 1u))
+    : threadPool(std::max(num_threads, 1u),
+                 []([[maybe_unused]] const size_t index) {
+                     VMC_PROFILE_THREAD("Chunk worker " + std::to_string(index));
+                 }),
+      terrainHeightNoise(seed), seed(seed), chunkSize(chunk_size), chunks(chunk_size)
 {
     // The number of threads for this world will always be at least 1.
 
@@ -128,10 +486,7 @@ World::~World()
     threadPool.purge();
     threadPool.wait();
 
-    for (auto& chunk : chunks)
-    {
-        free(chunk.second);
-    }
+    chunks.forEach([](Chunk* chunk) { delete chunk; });
 }
 
 void World::init(const glm::vec3& origin, const unsigned radius)
@@ -139,215 +494,329 @@ void World::init(const glm::vec3& origin, const unsigned radius)
     std::cout << ">>> Generating world with seed (" << seed << ") using (" << threadPool.get_thread_count()
               << ") threads..." << std::endl;
 
+    const auto start_time = std::chrono::steady_clock::now();
     const unsigned total_num_chunks = updateChunks(origin, radius);
 
-    // Report an update every second.
-    do
+    // The player can only collide with generated chunks, so wait for the ones around them; chunks that were never
+    // requested (e.g. outside a limited vertical radius) are not waited for.
+    constexpr std::array<glm::ivec3, 7> spawn_offsets = {
+        glm::ivec3(0, 0, 0),
+        glm::ivec3(1, 0, 0),  // +x
+        glm::ivec3(0, 1, 0),  // +y
+        glm::ivec3(0, 0, 1),  // +z
+        glm::ivec3(-1, 0, 0), // -x
+        glm::ivec3(0, -1, 0), // -y
+        glm::ivec3(0, 0, -1), // -z
+    };
+    const ChunkCenter origin_cc = getPosToChunkCenter(origin);
+    std::vector<ChunkCenter> spawn_chunk_centers;
+    for (const auto& offset : spawn_offsets)
     {
-        std::cout << "  Loaded " << (total_num_chunks - chunksToAdd.size()) << "/" << total_num_chunks << " chunks."
-                  << std::endl;
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-    } while (!chunksToAdd.empty());
+        spawn_chunk_centers.push_back(getOffsetChunkCenter(origin_cc, offset));
+    }
+    waitForChunks(spawn_chunk_centers);
 
-    std::cout << "  Loaded " << (total_num_chunks - chunksToAdd.size()) << "/" << total_num_chunks << " chunks."
-              << std::endl;
+    size_t num_remaining = 0;
+    {
+        std::lock_guard<std::mutex> lock(chunksToAddMutex);
+        num_remaining = chunksToAdd.size();
+    }
 
-    std::cout << ">>> Finished loading world!" << std::endl;
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start_time;
+    std::cout << ">>> Spawn area ready in " << elapsed.count() << " ms; " << num_remaining << "/" << total_num_chunks
+              << " chunks are still loading." << std::endl;
 }
 
-std::optional<glm::vec3> World::getReachableBlock(const Ray& ray, glm::ivec3* face_entered)
+void World::waitForChunks(const std::vector<ChunkCenter>& chunk_centers)
 {
-    std::shared_lock<std::shared_mutex> lock(chunksMutex);
+    std::unique_lock<std::mutex> lock(chunksToAddMutex);
+    chunkAddedCondition.wait(lock, [this, &chunk_centers]() {
+        return std::none_of(chunk_centers.begin(), chunk_centers.end(), [this](const ChunkCenter& cc) {
+            return chunksToAdd.contains(cc);
+        });
+    });
+}
 
-    std::optional<glm::vec3> reachable_block_pos;
+void World::waitForChunks(const Aabb3d& region)
+{
+    // Every chunk that contains a block overlapping the region; see `doesEntityIntersect()` for the block range.
+    const float fp_chunk_size = static_cast<float>(chunkSize);
+    const ChunkCenter min_cc = getPosToChunkCenter(glm::ceil(region.getMinBounds() - 0.5f));
+    const ChunkCenter max_cc = getPosToChunkCenter(glm::floor(region.getMaxBounds() + 0.5f));
+    std::vector<ChunkCenter> chunk_centers;
+    for (float z = min_cc.z; z <= max_cc.z; z += fp_chunk_size)
+    {
+        for (float y = min_cc.y; y <= max_cc.y; y += fp_chunk_size)
+        {
+            for (float x = min_cc.x; x <= max_cc.x; x += fp_chunk_size)
+            {
+                chunk_centers.emplace_back(x, y, z);
+            }
+        }
+    }
+    waitForChunks(chunk_centers);
+}
 
+std::optional<glm::vec3> World::getReachableBlock(const Ray& ray, glm::ivec3* face_entered)
+{
     // Under the assumption that the player's reach is never infinity.
+    assert(std::isfinite(ray.getMax()));
 
-    // Check the chunk that contains the ray's origin (the player's position).
-    const ChunkCenter cc = getPosToChunkCenter(ray.getOrigin());
-    if (isChunkActive(cc))
+    if (face_entered != nullptr)
     {
-        reachable_block_pos = chunks[cc]->getReachableBlock(ray, face_entered);
-    }
-    if (reachable_block_pos.has_value())
-    {
-        return reachable_block_pos;
+        *face_entered = glm::ivec3(0);
     }
 
-    // Check the chunk that contains the ray's direction at its max distance (where the player is
-    // looking).
-    const ChunkCenter next_cc = getPosToChunkCenter(ray.getOrigin() + ray.getDirection() * ray.getMax());
-    if (next_cc == cc)
+    // Walk the voxels that the ray passes through in order (Amanatides and Woo) and stop at the first solid one.
+    // Blocks are centered on integer positions, so voxel boundaries are at half-integers.
+    const glm::vec3 dir = ray.getDirection();
+    const glm::vec3 start = ray.getOrigin() + dir * ray.getMin();
+
+    glm::ivec3 voxel = glm::ivec3(glm::floor(start + 0.5f));
+    glm::ivec3 step{};
+    glm::vec3 t_next{}; // Ray parameter at which the next voxel boundary is crossed on each axis.
+    glm::vec3 t_delta{}; // Ray parameter between voxel boundaries on each axis.
+    for (glm::length_t i = 0; i < 3; ++i)
     {
-        return reachable_block_pos;
+        if (dir[i] == 0.0f)
+        {
+            step[i] = 0;
+            t_next[i] = std::numeric_limits<float>::infinity();
+            t_delta[i] = std::numeric_limits<float>::infinity();
+            continue;
+        }
+
+        step[i] = (dir[i] > 0.0f) ? 1 : -1;
+        const float boundary = static_cast<float>(voxel[i]) + 0.5f * static_cast<float>(step[i]);
+        t_next[i] = ray.getMin() + (boundary - start[i]) / dir[i];
+        t_delta[i] = std::abs(1.0f / dir[i]);
     }
-    if (isChunkActive(next_cc))
+
+    glm::ivec3 face{}; // Zero while still in the voxel the ray started in.
+    ChunkCenter curr_cc = getPosToChunkCenter(glm::vec3(voxel));
+    const Chunk* chunk = isChunkActive(curr_cc) ? chunks.find(curr_cc) : nullptr;
+    while (true)
     {
-        reachable_block_pos = chunks[next_cc]->getReachableBlock(ray, face_entered);
-    }
+        const glm::vec3 block_pos(voxel);
+
+        // Only look up the chunk again after crossing into another one.
+        const ChunkCenter cc = getPosToChunkCenter(block_pos);
+        if (cc != curr_cc)
+        {
+            curr_cc = cc;
+            chunk = isChunkActive(cc) ? chunks.find(cc) : nullptr;
+        }
 
-    return reachable_block_pos;
+        if (chunk != nullptr && chunk->isBlockPresent(block_pos))
+        {
+            if (face_entered != nullptr)
+            {
+                *face_entered = face;
+            }
+            return block_pos;
+        }
+
+        // Step across the nearest boundary unless it is beyond the ray's reach.
+        glm::length_t axis = 0;
+        if (t_next[1] < t_next[axis])
+        {
+            axis = 1;
+        }
+        if (t_next[2] < t_next[axis])
+        {
+            axis = 2;
+        }
+        if (t_next[axis] > ray.getMax())
+        {
+            return std::nullopt;
+        }
+
+        voxel[axis] += step[axis];
+        t_next[axis] += t_delta[axis];
+        face = glm::ivec3(0);
+        face[axis] = -step[axis]; // The entered face points back towards the ray's origin.
+    }
 }
 
 bool World::doesEntityIntersect(
-    const glm::vec3& pos,
     const glm::vec3& velocity,
     const float delta,
     const Aabb3d& hitbox,
     float& new_delta,
     glm::vec3* normal)
 {
-    // Given the entity's position, determine which chunks to check.
     // TODO: entity can go so fast that the chunks haven't loaded yet; can maybe add boundaries to already loaded chunks
     // where the player cannot enter chunks that haven't been loaded?
-    // TODO: maybe add all chunks relevant to the player's displacement?
-    std::unordered_set<ChunkCenter> chunk_centers;
-    std::vector<ChunkCenter> offsets = {
-        {0.0f,       0.0f,       0.0f      },
-        {chunkSize,  0.0f,       0.0f      },
-        {-chunkSize, 0.0f,       0.0f      },
-        {0.0f,       chunkSize,  0.0f      },
-        {0.0f,       -chunkSize, 0.0f      },
-        {0.0f,       0.0f,       chunkSize },
-        {0.0f,       0.0f,       -chunkSize},
-    };
-    for (const auto& offset : offsets)
-    {
-
-        {
-            std::shared_lock<std::shared_mutex> lock(chunksMutex);
-
-            const ChunkCenter cc = getPosToChunkCenter(pos) + offset;
-            if (chunks.contains(cc))
-            {
-                chunk_centers.emplace(cc);
-            }
-        }
-    }
-
-    // Ask the chunks to run intersection test on this entity and return the result.
     new_delta = delta;
     bool intersected = false;
     glm::vec3 closest_normal{};
-    for (const auto& cc : chunk_centers)
-    {
-        float curr_new_delta;
-        glm::vec3 curr_normal;
 
-        {
-            std::shared_lock<std::shared_mutex> lock(chunksMutex);
+    // Only the blocks that overlap the space swept by the entity can be hit. Blocks are centered on integer positions
+    // and span half a block on each side, so a block at `k` overlaps `[min, max]` when `min - 0.5 <= k <= max + 0.5`.
+    const Aabb3d broad_phase_aabb = CollisionHandler::getBroadPhaseAabb(hitbox, velocity, delta);
+    const glm::ivec3 min_block = glm::ivec3(glm::ceil(broad_phase_aabb.getMinBounds() - 0.5f));
+    const glm::ivec3 max_block = glm::ivec3(glm::floor(broad_phase_aabb.getMaxBounds() + 0.5f));
+
+    // Gather the solid blocks, then sweep against all of them at once. The range can span several chunks; only look
+    // one up again after crossing into it.
+    thread_local Aabb3dBatch block_hitboxes; // Reused between calls; entities are moved from several threads.
+    block_hitboxes.clear();
 
-            if (chunks[cc]->doesEntityIntersect(velocity, delta, hitbox, curr_new_delta, &curr_normal))
+    std::optional<ChunkCenter> curr_cc;
+    const Chunk* chunk = nullptr;
+    for (int z = min_block.z; z <= max_block.z; ++z)
+    {
+        for (int y = min_block.y; y <= max_block.y; ++y)
+        {
+            for (int x = min_block.x; x <= max_block.x; ++x)
             {
-                if (curr_new_delta < new_delta)
+                const glm::vec3 block_pos(x, y, z);
+
+                const ChunkCenter cc = getPosToChunkCenter(block_pos);
+                if (cc != curr_cc)
                 {
-                    new_delta = curr_new_delta;
-                    closest_normal = curr_normal;
+                    curr_cc = cc;
+                    chunk = chunks.find(cc);
+                }
+                if (chunk != nullptr && chunk->isBlockPresent(block_pos))
+                {
+                    block_hitboxes.add(block_pos - glm::vec3(0.5f), block_pos + glm::vec3(0.5f));
                 }
-                intersected = true;
             }
         }
     }
 
+    glm::vec3 curr_normal{};
+    const float t_min = CollisionHandler::sweptAabbPerAxis(hitbox, block_hitboxes, velocity, delta, curr_normal);
+
+    assert(t_min >= 0.0f);
+    if (t_min != std::numeric_limits<float>::infinity())
+    {
+        // Get the minimum because it represents the closest collision.
+        if (t_min < new_delta)
+        {
+            new_delta = t_min;
+            closest_normal = curr_normal;
+        }
+        intersected = true;
+    }
+
     if (normal != nullptr)
     {
         *normal = closest_normal;
     }
 
-    // No intersection was found, so return false.
     return intersected;
 }
 
-void World::addChunk(const std::vector<glm::vec3> chunk_centers)
+void World::addChunk(const ChunkCenter& cc)
 {
-    for (const auto& cc : chunk_centers)
-    {
-        {
-            std::shared_lock<std::shared_mutex> lock(chunksMutex);
+    VMC_PROFILE_ZONE("World::addChunk");
 
-            // Don't generate the chunk if it was already generated by another thread.
-            if (chunks.contains(cc))
-            {
-                continue;
-            }
-        }
+    // Don't generate the chunk if it was already generated by another thread.
+    if (chunks.contains(cc))
+    {
+        return;
+    }
 
-        Chunk* chunk = new Chunk(terrainHeightNoise, cc, chunkSize);
+    const auto start_time = std::chrono::steady_clock::now();
 
+    Chunk* chunk = (pChunkCache != nullptr) ? pChunkCache->load(terrainHeightNoise, cc, chunkSize) : nullptr;
+    if (chunk == nullptr)
+    {
+        chunk = new Chunk(terrainHeightNoise, cc, chunkSize);
+        if (pChunkCache != nullptr)
         {
-            std::lock_guard<std::shared_mutex> lock(chunksMutex);
+            pChunkCache->store(*chunk); // Best effort; a chunk that isn't stored is just generated again next time.
+        }
+    }
 
-            assert(!chunks.contains(cc));
+    std::array<Chunk*, 6> neighbors{};
+    {
+        std::unique_lock<std::shared_mutex> lock(chunkEditMutex, std::defer_lock);
+        lockChunkEdits(lock);
+
+        [[maybe_unused]] const bool inserted = chunks.insert(cc, chunk);
+        assert(inserted);
 
-            chunks[cc] = chunk;
+        {
+            std::lock_guard<std::mutex> to_add_lock(chunksToAddMutex);
             chunksToAdd.erase(cc);
+        }
+        chunkAddedCondition.notify_all();
 
-            // Assign loaded neighbors to this chunk and assign this chunk to its neighbors.
-            auto neighbors = getNeighboringChunks(cc);
-            for (size_t i = 0; i < neighbors.size(); ++i)
+        // Assign loaded neighbors to this chunk and assign this chunk to its neighbors.
+        neighbors = getNeighboringChunks(cc);
+        for (size_t i = 0; i < neighbors.size(); ++i)
+        {
+            Chunk* neighbor = neighbors[i];
+
+            if (neighbor == nullptr)
             {
-                Chunk* neighbor = neighbors[i];
+                continue;
+            }
 
-                if (neighbor == nullptr)
-                {
-                    continue;
-                }
+            chunk->setNeighboringChunk(static_cast<Axis>(i), neighbor);
 
-                chunk->neighboringChunks[i] = neighbor;
+            // Order of `neighboringChunks` is +x, +y, +z, -x, -y, and -z.
+            // Observe the positive axes are the first 3 while the last 3 are negative axes.
+            // The neighbor's neighbor (new chunk) will be the negation of this chunk's axis to its neighbor.
+            const size_t j = (i < 3) ? (i + 3) : (i - 3); // Neighbor's perspective.
+            neighbor->setNeighboringChunk(static_cast<Axis>(j), chunk);
+        }
+    }
 
-                // Order of `neighboringChunks` is +x, +y, +z, -x, -y, and -z.
-                // Observe the positive axes are the first 3 while the last 3 are negative axes.
-                // The neighbor's neighbor (new chunk) will be the negation of this chunk's axis to its neighbor.
-                const size_t j = (i < 3) ? (i + 3) : (i - 3); // Neighbor's perspective.
-                neighbor->neighboringChunks[j] = chunk;
+    recordStageTime(stageTimings.generated, start_time);
+    chunks_generated_counter.add();
 
-                // Make sure the neighbor is reloaded if it has a newly loaded neighbor and is visible.
-                if (visibleChunks.contains(neighbor->getCenter()))
-                {
-                    runChunkLoadedCallbacks(*neighbor);
-                }
-            }
+    // This chunk may have completed its own neighborhood and/or that of its neighbors.
+    meshChunkIfReady(chunk);
+    for (Chunk* neighbor : neighbors)
+    {
+        if (neighbor != nullptr)
+        {
+            meshChunkIfReady(neighbor);
         }
     }
 }
 
-void World::draw(const glm::vec3& origin, const unsigned radius, const Frustum& frustum)
+void World::draw(const Frustum& frustum)
 {
-    // Load all chunks visible to the player.
-    const int render_distance = static_cast<int>(radius);
-    const float offset = static_cast<float>(render_distance * chunkSize);
+    VMC_PROFILE_ZONE("World::draw");
 
-    std::unordered_set<ChunkCenter> hidden_chunks = visibleChunks;
-    const float chunk_extent = chunkSize * 0.5f;
-
-    // Iterate through new and/or old active chunks.
-    float x = origin.x - offset;
-    for (int i = 0; i <= (render_distance * 2); ++i)
+    // Pick up the chunks that were meshed since the last draw.
     {
-        float y = origin.y - offset;
-        for (int j = 0; j <= (render_distance * 2); ++j)
+        std::lock_guard<std::mutex> lock(meshedChunksMutex);
+
+        for (Chunk* chunk : meshedChunks)
         {
-            float z = origin.z - offset;
-            for (int k = 0; k <= (render_distance * 2); ++k)
+            updateChunkBounds(chunk);
+            if (!isChunkActive(chunk->getCenter()))
             {
-                const ChunkCenter cc = getPosToChunkCenter({x, y, z});
-
-                // Handle chunk visibility; whether this active chunk is visible according to the frustum.
-                const Aabb3d chunk_collider((cc - chunk_extent), (cc + chunk_extent));
-                const bool in_frustum = frustum.isAabbInside(chunk_collider);
-                if (in_frustum)
-                {
-                    hidden_chunks.erase(cc);
-                    if (!visibleChunks.contains(cc))
-                    {
-                        chunksToShow.emplace(cc);
-                    }
-                }
-                z += chunkSize;
+                releaseChunkMesh(chunk); // Left the range while it was being meshed.
             }
-            y += chunkSize;
         }
-        x += chunkSize;
+        meshedChunks.clear();
+    }
+
+    // Only active chunks with a mesh are in the tree, so every chunk it returns is ready to be shown.
+    visibleChunkCoords.clear();
+    chunkBoundsTree.cull(frustum, visibleChunkCoords);
+
+    std::unordered_set<ChunkCenter> hidden_chunks = visibleChunks;
+    for (const auto& coord : visibleChunkCoords)
+    {
+        const ChunkCenter cc = glm::vec3(coord) * static_cast<float>(chunkSize);
+        if (hidden_chunks.erase(cc) > 0)
+        {
+            continue;
+        }
+
+        Chunk* chunk = chunks.find(cc);
+        assert(chunk != nullptr && chunk->getState() >= Chunk::State::MESHED);
+        visibleChunks.emplace(cc);
+        runChunkLoadedCallbacks(*chunk);
+        chunk->setState(Chunk::State::UPLOADED);
     }
 
     // Remove now hidden chunks.
@@ -355,107 +824,156 @@ void World::draw(const glm::vec3& origin, const unsigned radius, const Frustum&
     {
         visibleChunks.erase(cc);
 
+        Chunk* chunk = chunks.find(cc);
+        if (chunk != nullptr)
         {
-            std::shared_lock<std::shared_mutex> lock(chunksMutex);
-
-            if (chunks.contains(cc))
+            runChunkUnloadedCallbacks(*chunk);
+            chunk->advanceState(Chunk::State::UPLOADED, Chunk::State::MESHED);
+            if (!isChunkActive(cc))
             {
-                runChunkUnloadedCallbacks(*chunks[cc]);
+                releaseChunkMesh(chunk);
             }
         }
     }
 
-    // Add any visible chunks that are now ready.
-    if (!chunksToShow.empty())
+    visible_chunks_gauge.set(static_cast<double>(visibleChunks.size()));
+    queued_tasks_gauge.set(static_cast<double>(threadPool.get_tasks_queued()));
+}
+
+unsigned World::updateChunks(const glm::vec3& origin, const unsigned radius)
+{
+    VMC_PROFILE_ZONE("World::updateChunks");
+
+    // Only update the chunks that entered or exited the range since the last update. A chunk is only meshed once its 6
+    // neighbors are generated, so the range reaches one chunk past `radius` for every chunk within it to be drawn.
+    const ChunkCenter origin_cc = getPosToChunkCenter(origin);
+    const unsigned requested_radius = radius + 1;
+
+    std::vector<ChunkCenter> entered_chunk_centers;
+    std::vector<ChunkCenter> exited_chunk_centers;
+    getActiveChunksDiff(origin_cc, requested_radius, entered_chunk_centers, exited_chunk_centers);
+    activeCenter = origin_cc;
+
+    if (entered_chunk_centers.empty() && exited_chunk_centers.empty())
+    {
+        return 0;
+    }
+
+    // Request the newly active chunks; nearest first.
+    std::vector<ChunkCenter> new_chunk_centers;
     {
-        std::vector<ChunkCenter> to_remove;
-        to_remove.reserve(chunksToShow.size());
-        for (const auto& cc : chunksToShow)
+        std::lock_guard<std::mutex> lock(chunksToAddMutex);
+
+        for (const auto& cc : entered_chunk_centers)
         {
+            if (!chunks.contains(cc))
             {
-                std::shared_lock<std::shared_mutex> lock(chunksMutex);
-
-                if (chunks.contains(cc))
+                if (!chunksToAdd.contains(cc))
                 {
-                    visibleChunks.emplace(cc);
-                    to_remove.push_back(cc);
-                    runChunkLoadedCallbacks(*chunks[cc]);
-                }
+                    // Create the chunk asynchrounously and add it later.
+                    chunksToAdd.emplace(cc);
+                    new_chunk_centers.emplace_back(cc);
+                } // Else, don't add it to the set of chunks to add because it's already
+                  // in there.
             }
         }
-        for (const auto& cc : to_remove)
+    }
+
+    // Only the chunks within the range keep a host copy of their mesh, which bounds the memory meshes take to the
+    // render distance; visible chunks release theirs once `draw()` has unloaded them. Chunks that are already meshed
+    // can be culled right away; the rest are added to the tree (again) once they are meshed.
+    for (const auto& cc : exited_chunk_centers)
+    {
+        chunkBoundsTree.erase(getChunkCoord(cc));
+
+        Chunk* chunk = chunks.find(cc);
+        if (chunk != nullptr)
+        {
+            releaseChunkMesh(chunk);
+        }
+    }
+    for (const auto& cc : entered_chunk_centers)
+    {
+        Chunk* chunk = chunks.find(cc);
+        if (chunk != nullptr)
         {
-            chunksToShow.erase(cc);
+            updateChunkBounds(chunk);
+            meshChunkIfReady(chunk);
         }
     }
+
+    runActiveChunksChangedCallbacks(entered_chunk_centers, exited_chunk_centers);
+
+    // Generate chunks asynchronously; nearer chunks get a higher priority.
+    for (const auto& cc : new_chunk_centers)
+    {
+        const int dist = static_cast<int>(glm::length((cc - origin_cc) / static_cast<float>(chunkSize)));
+        const auto priority = static_cast<BS::priority_t>(std::max(GENERATE_TASK_PRIORITY - dist, -128));
+        threadPool.detach_task(
+            [this, cc, request_time = std::chrono::steady_clock::now()]() {
+                recordStageTime(stageTimings.queued, request_time);
+                addChunk(cc);
+            },
+            priority);
+    }
+
+    return static_cast<unsigned>(new_chunk_centers.size());
 }
 
-unsigned World::updateChunks(const glm::vec3& origin, const unsigned radius)
+size_t World::remeshDirtyChunks(const std::chrono::microseconds budget)
 {
-    // Load all chunks visible to the player.
-    const int render_distance = static_cast<int>(radius);
-    const float offset = static_cast<float>(render_distance * chunkSize);
+    VMC_PROFILE_ZONE("World::remeshDirtyChunks");
 
-    std::vector<ChunkCenter> new_chunk_centers;
-    activeChunks.clear();
+    if (dirtyChunksQueue.empty())
+    {
+        return 0;
+    }
+
+    const auto start_time = std::chrono::steady_clock::now();
 
-    // Iterate through new active chunks.
-    float x = origin.x - offset;
-    for (int i = 0; i <= (render_distance * 2); ++i)
+    std::shared_lock<std::shared_mutex> lock(chunkEditMutex);
+
+    // Always handle at least one entry so a small budget can't starve the queue. Chunks whose mesh is still being built
+    // stay dirty and are retried at the back of the queue, which counts against the budget too; remeshing them then is
+    // at worst redundant. Chunks that released their mesh are no longer dirty, so their entries are just dropped.
+    size_t num_dequeued = 0;
+    size_t num_remeshed = 0;
+    std::vector<ChunkCenter> deferred_chunks;
+    while (num_dequeued < dirtyChunksQueue.size())
     {
-        float y = origin.y - offset;
-        for (int j = 0; j <= (render_distance * 2); ++j)
+        const ChunkCenter cc = dirtyChunksQueue[num_dequeued];
+        ++num_dequeued;
+
+        if (dirtyChunks.contains(cc))
         {
-            float z = origin.z - offset;
-            for (int k = 0; k <= (render_distance * 2); ++k)
+            Chunk* chunk = chunks.find(cc);
+            if (chunk != nullptr && !remeshChunk(chunk))
             {
-                const ChunkCenter cc = getPosToChunkCenter({x, y, z});
-
-                // Make sure the chunk is marked as active even if it hasn't loaded.
-                activeChunks.emplace(cc);
-
+                deferred_chunks.push_back(cc);
+            }
+            else
+            {
+                dirtyChunks.erase(cc);
+                if (chunk != nullptr)
                 {
-                    std::shared_lock<std::shared_mutex> lock(chunksMutex);
-
-                    if (!chunks.contains(cc))
-                    {
-                        if (!chunksToAdd.contains(cc))
-                        {
-                            // Create the chunk asynchrounously and add it later.
-                            chunksToAdd.emplace(cc);
-                            new_chunk_centers.emplace_back(cc);
-                        } // Else, don't add it to the set of chunks to add because it's already
-                          // in there.
-                    }
+                    ++remeshStats.processed;
+                    remesh_processed_counter.add();
+                    ++num_remeshed;
                 }
-
-                z += chunkSize;
             }
-            y += chunkSize;
         }
-        x += chunkSize;
-    }
 
-    // Add chunks in batches asynchronously.
-    if (!new_chunk_centers.empty())
-    {
-        // Give a batch of chunks to a `num_sections` async thread(s) to process.
-        const size_t num_sections = threadPool.get_thread_count(); // Guaranteed to be at least 1 thread.
-        const size_t section_size = new_chunk_centers.size() / num_sections;
-        for (size_t section_i = 0; section_i < num_sections - 1; ++section_i)
+        if (std::chrono::steady_clock::now() - start_time >= budget)
         {
-            std::vector<ChunkCenter> section(
-                new_chunk_centers.begin() + section_size * section_i,
-                new_chunk_centers.begin() + section_size * (section_i + 1));
-            threadPool.detach_task([this, section]() { addChunk(section); });
+            break;
         }
-        std::vector<ChunkCenter> section(
-            new_chunk_centers.begin() + section_size * (num_sections - 1),
-            new_chunk_centers.end());
-        threadPool.detach_task([this, section]() { addChunk(section); });
     }
 
-    return static_cast<unsigned>(new_chunk_centers.size());
+    // Whatever is left over is picked up next frame, still in order.
+    dirtyChunksQueue.erase(dirtyChunksQueue.begin(), dirtyChunksQueue.begin() + num_dequeued);
+    dirtyChunksQueue.insert(dirtyChunksQueue.end(), deferred_chunks.begin(), deferred_chunks.end());
+
+    return num_remeshed;
 }
 
 void World::addBlock(const glm::vec3 block_pos)
@@ -488,6 +1006,17 @@ void World::clearChunkUnloadedCallbacks()
     chunkUnloadedCallbacks.clear();
 }
 
+void World::addActiveChunksChangedCallback(
+    const std::function<void(const std::vector<ChunkCenter>&, const std::vector<ChunkCenter>&)>& callback)
+{
+    activeChunksChangedCallbacks.push_back(callback);
+}
+
+void World::clearActiveChunksChangedCallbacks()
+{
+    activeChunksChangedCallbacks.clear();
+}
+
 const ChunkCenter World::getPosToChunkCenter(const glm::vec3& pos) const
 {
     const float fp_chunk_size = static_cast<float>(chunkSize);
@@ -498,6 +1027,51 @@ const ChunkCenter World::getPosToChunkCenter(const glm::vec3& pos) const
     return ChunkCenter(x, y, z);
 }
 
+uint64_t World::getBlocksHash() const
+{
+    // The registry visits chunks in no particular order.
+    std::vector<std::pair<ChunkCenter, uint64_t>> chunk_hashes;
+    chunk_hashes.reserve(chunks.size());
+    chunks.forEach([&chunk_hashes](const Chunk* chunk) {
+        chunk_hashes.emplace_back(chunk->getCenter(), chunk->getBlocksHash());
+    });
+    std::sort(chunk_hashes.begin(), chunk_hashes.end(), [](const auto& a, const auto& b) {
+        return std::tie(a.first.x, a.first.y, a.first.z) < std::tie(b.first.x, b.first.y, b.first.z);
+    });
+
+    uint64_t hash = 0;
+    for (const auto& [cc, chunk_hash] : chunk_hashes)
+    {
+        hash = hash * 1099511628211ull + chunk_hash;
+    }
+    return hash;
+}
+
+bool World::enableChunkCache(const std::filesystem::path& directory)
+{
+    auto p_chunk_cache = std::make_unique<ChunkCache>(directory, seed);
+    if (!p_chunk_cache->isOpen())
+    {
+        return false;
+    }
+    pChunkCache = std::move(p_chunk_cache);
+    return true;
+}
+
+const ChunkCache* World::getChunkCache() const
+{
+    return pChunkCache.get();
+}
+
+void World::setVerticalRadius(const std::optional<unsigned> radius)
+{
+    // One more layer is requested than drawn, as with the horizontal radius in `updateChunks()`.
+    verticalRadius = radius.has_value() ? std::optional<unsigned>(radius.value() + 1) : std::nullopt;
+
+    // Force the offsets to be rebuilt with the new shape.
+    chunkOffsets.clear();
+}
+
 // const Model World::getModel() const
 //{
 //     std::vector<Model::Vertex> vertices;
@@ -536,3 +1110,29 @@ float World::getGravity() const
 {
     return gravity;
 }
+
+const FastNoiseLite& World::getTerrainHeightNoise() const
+{
+    return terrainHeightNoise;
+}
+
+BS::priority_thread_pool& World::getThreadPool()
+{
+    return threadPool;
+}
+
+const World::RemeshStats& World::getRemeshStats() const
+{
+    return remeshStats;
+}
+
+void World::setStageTimingsEnabled(const bool enabled)
+{
+    areStageTimingsEnabled = enabled;
+}
+
+World::StageTimings World::getStageTimings() const
+{
+    std::lock_guard<std::mutex> lock(stageTimingsMutex);
+    return stageTimings;
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "chunk-bounds-tree.hpp"
+#include "chunk-cache.hpp"
+#include "chunk-registry.hpp"
 #include "chunk.hpp"
 
 #include "engine/frustum.hpp"
@@ -7,6 +10,13 @@
 #include "BS_thread_pool.hpp"
 #include <glm/gtx/hash.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <shared_mutex>
 #include <string>
 #include <unordered_map>
@@ -15,9 +25,36 @@
 
 class World
 {
+  public:
+    // Counts of remesh requests for chunks whose contents changed; `requested - processed` remeshes were saved.
+    struct RemeshStats
+    {
+        size_t requested = 0; // Every invalidation, including repeats of an already dirty chunk.
+        size_t coalesced = 0; // Invalidations merged into an already pending remesh.
+        size_t processed = 0; // Remeshes that were actually run.
+    };
+
+    // Time each chunk spent in each stage of the pipeline; one sample per chunk and stage.
+    struct StageTimings
+    {
+        std::vector<std::chrono::nanoseconds> queued;    // From being requested until its generation starts.
+        std::vector<std::chrono::nanoseconds> generated; // Generating its blocks and linking its neighbors.
+        std::vector<std::chrono::nanoseconds> meshed;    // Building its mesh.
+    };
+
   private:
-    BS::thread_pool<> threadPool;
-    std::shared_mutex chunksMutex;
+    // Chunks flow through the pool in stages: generate and link -> mesh (once all 6 neighbors exist); the main thread
+    // then uploads meshed chunks when they become visible. Later stages run first so finished work drains quickly.
+    static constexpr BS::priority_t MESH_TASK_PRIORITY = BS::pr::high;
+    static constexpr BS::priority_t GENERATE_TASK_PRIORITY = BS::pr::normal; // Lowered by distance to the player.
+
+    BS::priority_thread_pool threadPool;
+
+    // Changing chunk contents or neighbor links needs exclusive access; reading them (e.g. meshing) needs shared
+    // access. Looking up chunks does not need it since `chunks` has its own locks.
+    std::shared_mutex chunkEditMutex;
+    std::mutex chunksToAddMutex;
+    std::condition_variable chunkAddedCondition; // Notified whenever a chunk leaves `chunksToAdd`.
 
     FastNoiseLite terrainHeightNoise;
     unsigned seed;
@@ -25,47 +62,113 @@ class World
 
     float gravity = -9.8f;
 
+    // Offsets (in chunks) from the center chunk that are within the render distance; sorted from nearest to furthest
+    // so that iterating it also gives the load priority. Rebuilt only when the render distance changes.
+    std::vector<glm::ivec3> chunkOffsets;
+    unsigned chunkOffsetsRadius = 0;
+    std::optional<unsigned> verticalRadius; // If set, use a cylinder instead of a sphere; includes the meshing ring.
+
+    // Slabs of `chunkOffsets` that enter/exit the range when the center moves by one chunk; indexed by `Axis`.
+    // Entering offsets are relative to the new center and exiting offsets are relative to the old center.
+    std::array<std::vector<glm::ivec3>, 6> enteringChunkOffsets;
+    std::array<std::vector<glm::ivec3>, 6> exitingChunkOffsets;
+
     // TODO: currently, a cache of chunks; will probably need an eviction policy to save memory;
     // maybe don't cache chunks at all and store world data in persistant memory and load them when needed;
     // maybe use a combination where inactive cached chunks are written to persistent memory.
-    std::unordered_map<ChunkCenter, Chunk*> chunks;
-    std::unordered_set<ChunkCenter> chunksToAdd;
+    ChunkRegistry chunks;
+    std::unique_ptr<ChunkCache> pChunkCache; // Optional; set before any chunk is requested.
+    std::unordered_set<ChunkCenter> chunksToAdd; // Guarded by `chunksToAddMutex`.
     std::unordered_set<ChunkCenter> activeChunks;
-    std::unordered_set<ChunkCenter> chunksToShow;
+    std::optional<ChunkCenter> activeCenter; // Center chunk that `activeChunks` was last built around.
     std::unordered_set<ChunkCenter> visibleChunks;
 
+    // Bounds of the active chunks that have something to draw, for culling; kept up to date as chunks are (re)meshed
+    // and enter or exit the range.
+    ChunkBoundsTree chunkBoundsTree;
+    std::vector<glm::ivec3> visibleChunkCoords;
+
+    // Chunks meshed by worker threads since the last draw; the main thread adds them to `chunkBoundsTree`.
+    std::mutex meshedChunksMutex;
+    std::vector<Chunk*> meshedChunks; // Guarded by `meshedChunksMutex`.
+
+    // Chunks waiting to be remeshed on the main thread, in the order they were first invalidated; a chunk is only
+    // queued again once it is no longer dirty. A chunk stays dirty until it has actually been remeshed or has released
+    // its mesh; queued chunks that are no longer dirty are skipped.
+    std::vector<ChunkCenter> dirtyChunksQueue;
+    std::unordered_set<ChunkCenter> dirtyChunks;
+    RemeshStats remeshStats;
+
+    // Only recorded while enabled since the samples grow with every chunk.
+    std::atomic<bool> areStageTimingsEnabled = false;
+    mutable std::mutex stageTimingsMutex;
+    StageTimings stageTimings; // Guarded by `stageTimingsMutex`.
+
     std::vector<std::function<void(const Chunk&)>> chunkLoadedCallbacks;
     std::vector<std::function<void(const Chunk&)>> chunkUnloadedCallbacks;
-    std::vector<std::function<void()>> chunksChangedCallbacks;
+    std::vector<std::function<void(const std::vector<ChunkCenter>&, const std::vector<ChunkCenter>&)>>
+        activeChunksChangedCallbacks;
 
     void runChunkLoadedCallbacks(const Chunk& chunk);
     void runChunkUnloadedCallbacks(const Chunk& chunk);
+    void runActiveChunksChangedCallbacks(
+        const std::vector<ChunkCenter>& entered,
+        const std::vector<ChunkCenter>& exited);
 
     bool isChunkActive(const ChunkCenter& cc) const;
+    void waitForChunks(const std::vector<ChunkCenter>& chunk_centers);
+
+    bool isOffsetInRange(const glm::ivec3& offset, const unsigned radius) const;
+    const std::vector<glm::ivec3>& getChunkOffsets(const unsigned radius);
+    ChunkCenter getOffsetChunkCenter(const ChunkCenter& cc, const glm::ivec3& offset) const;
+    glm::ivec3 getChunkCoord(const ChunkCenter& cc) const;
+    void getActiveChunksDiff(
+        const ChunkCenter& new_cc,
+        const unsigned radius,
+        std::vector<ChunkCenter>& entered,
+        std::vector<ChunkCenter>& exited);
 
     std::array<Chunk*, 6> getNeighboringChunks(const ChunkCenter& cc) const;
 
+    void meshChunkIfReady(Chunk* chunk);
+    void meshChunk(Chunk* chunk);
+    bool remeshChunk(Chunk* chunk);
+    void releaseChunkMesh(Chunk* chunk);
+    void markChunkDirty(const ChunkCenter& cc);
+    void recordStageTime(
+        std::vector<std::chrono::nanoseconds>& samples,
+        const std::chrono::steady_clock::time_point start_time);
+    void updateChunkBounds(const Chunk* chunk);
+
     void editBlock(const glm::vec3 block_pos, const bool should_add);
 
   public:
     World(const unsigned seed, const int chunk_size, const unsigned num_threads = 1);
     ~World();
 
+    // Requests the chunks around `origin` like `updateChunks()` but only waits for the chunk containing `origin` and
+    // its 6 neighbors; the rest are generated in the background, nearest first.
     void init(const glm::vec3& origin, const unsigned radius);
 
+    // Blocks until every requested chunk containing part of `region` is generated, e.g. so a tick always sees the same
+    // blocks no matter how far generation got; chunks that were never requested are not waited for.
+    void waitForChunks(const Aabb3d& region);
+
     std::optional<glm::vec3> getReachableBlock(const Ray& ray, glm::ivec3* face_entered = nullptr);
     bool doesEntityIntersect(
-        const glm::vec3& pos,
         const glm::vec3& velocity,
         const float delta,
         const Aabb3d& hitbox,
         float& new_delta,
         glm::vec3* normal = nullptr);
 
-    void addChunk(const std::vector<glm::vec3> chunk_center);
+    void addChunk(const ChunkCenter& cc);
 
-    void draw(const glm::vec3& origin, const unsigned radius, const Frustum& frustum);
+    void draw(const Frustum& frustum);
+    // Makes the chunks within `radius + 1` of `origin` active and requests the new ones, since a chunk is only meshed
+    // once its 6 neighbors are generated; this way every chunk within `radius` is drawn. Returns the number requested.
     unsigned updateChunks(const glm::vec3& origin, const unsigned radius);
+    size_t remeshDirtyChunks(const std::chrono::microseconds budget); // Returns the number of chunks remeshed.
 
     void addBlock(const glm::vec3 block_pos);
     void removeBlock(const glm::vec3 block_pos);
@@ -76,7 +179,29 @@ class World
     void addChunkUnloadedCallback(const std::function<void(const Chunk&)>& callback);
     void clearChunkUnloadedCallbacks();
 
+    void addActiveChunksChangedCallback(
+        const std::function<void(const std::vector<ChunkCenter>&, const std::vector<ChunkCenter>&)>& callback);
+    void clearActiveChunksChangedCallbacks();
+
     const ChunkCenter getPosToChunkCenter(const glm::vec3& pos) const;
 
+    // Of the blocks of every chunk generated so far, e.g. to check that two sessions ended up with the same world. Only
+    // meaningful while no chunks are being generated, i.e. after waiting for the thread pool.
+    uint64_t getBlocksHash() const;
+
+    // Loads generated chunks from, and saves newly generated ones to, a cache in `directory`; returns false if the
+    // cache can't be used. Must be called before any chunk is requested.
+    bool enableChunkCache(const std::filesystem::path& directory);
+    const ChunkCache* getChunkCache() const; // Null unless enabled.
+
+    // Limits how far up and down chunks are drawn, like the radius passed to `updateChunks()` does sideways, which
+    // turns the range into a cylinder; empty for a sphere.
+    void setVerticalRadius(const std::optional<unsigned> radius);
+
     float getGravity() const;
+    const FastNoiseLite& getTerrainHeightNoise() const;
+    BS::priority_thread_pool& getThreadPool();
+    const RemeshStats& getRemeshStats() const;
+    void setStageTimingsEnabled(const bool enabled);
+    StageTimings getStageTimings() const;
 };
@@ -0,0 +1,254 @@
+// Steps a crowd of mobs over generated terrain with `EntitySystem` and checks that they collide with the world and
+// with each other: no mob ends up inside a solid block or falls out of the world, nearly all of them come to rest on
+// the ground, and the overlapping pairs found through the spatial hash match the ones a brute-force scan finds.
+//
+// Also prints how long the ticks took, as a benchmark of the entity system at the scale it is meant for.
+
+#include "entity-system.hpp"
+
+#include "engine/physics/collision-handler.hpp"
+#include "test-checker.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+constexpr unsigned WORLD_SEED = 1337;
+constexpr int CHUNK_SIZE = 16;
+constexpr unsigned RADIUS = 4; // In chunks; covers the whole terrain height around the origin.
+constexpr unsigned RNG_SEED = 4242;
+constexpr size_t NUM_ENTITIES = 10240;
+constexpr float SPAWN_HALF_SIZE = 48.0f; // In blocks, around the origin; well within the loaded chunks.
+constexpr float MAX_WALK_SPEED = 1.5f;   // Blocks per second; mobs can't get out of the loaded chunks in time.
+constexpr size_t NUM_TICKS = 300;        // Long enough for every mob to land.
+constexpr float DT = 1.0f / 60.0f;
+constexpr glm::vec3 HITBOX_MIN{-0.3f, 0.0f, -0.3f};
+constexpr glm::vec3 HITBOX_MAX{0.3f, 1.8f, 0.3f};
+constexpr float PENETRATION_TOLERANCE = 0.01f; // Entities are kept a small epsilon away, not exactly at the surface.
+constexpr float MIN_FRACTION_ON_FLOOR = 0.75f; // The rest stand on other mobs.
+
+bool isSolid(World& world, const glm::ivec3& block_pos)
+{
+    // A ray without length only looks at the block it starts in.
+    const Ray ray(glm::vec3(block_pos), glm::vec3(0.0f, -1.0f, 0.0f), 0.0f, 0.0f);
+    return world.getReachableBlock(ray).has_value();
+}
+
+// Of the highest block at `(x, z)`, or nothing if there isn't one in the loaded chunks.
+std::optional<float> getGroundHeight(World& world, const float x, const float z)
+{
+    const Ray down(glm::vec3(x, 60.0f, z), glm::vec3(0.0f, -1.0f, 0.0f), 0.0f, 120.0f);
+    const std::optional<glm::vec3> block_pos = world.getReachableBlock(down);
+    if (!block_pos.has_value())
+    {
+        return std::nullopt;
+    }
+    return block_pos.value().y + 0.5f;
+}
+
+// Blocks are centered on integer positions, so shrinking the hitbox by the tolerance and looking at every block that
+// overlaps what is left finds any block the entity is inside of.
+bool isInsideTerrain(World& world, const Aabb3d& hitbox)
+{
+    const glm::vec3 min_bounds = hitbox.getMinBounds() + PENETRATION_TOLERANCE;
+    const glm::vec3 max_bounds = hitbox.getMaxBounds() - PENETRATION_TOLERANCE;
+    const glm::ivec3 min_block = glm::ivec3(glm::ceil(min_bounds - 0.5f));
+    const glm::ivec3 max_block = glm::ivec3(glm::floor(max_bounds + 0.5f));
+    for (int z = min_block.z; z <= max_block.z; ++z)
+    {
+        for (int y = min_block.y; y <= max_block.y; ++y)
+        {
+            for (int x = min_block.x; x <= max_block.x; ++x)
+            {
+                if (isSolid(world, glm::ivec3(x, y, z)))
+                {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+std::vector<std::pair<EntitySystem::EntityId, EntitySystem::EntityId>> getBruteForceContacts(
+    const EntitySystem& entities,
+    const std::vector<EntitySystem::EntityId>& ids)
+{
+    std::vector<Aabb3d> hitboxes;
+    hitboxes.reserve(ids.size());
+    for (const EntitySystem::EntityId id : ids)
+    {
+        const glm::vec3 pos = entities.getPosition(id);
+        hitboxes.emplace_back(pos + HITBOX_MIN, pos + HITBOX_MAX);
+    }
+
+    std::vector<std::pair<EntitySystem::EntityId, EntitySystem::EntityId>> contacts;
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        for (size_t j = i + 1; j < ids.size(); ++j)
+        {
+            if (CollisionHandler::shapeToShapeIntersect(hitboxes[i], hitboxes[j], false))
+            {
+                contacts.emplace_back(std::min(ids[i], ids[j]), std::max(ids[i], ids[j]));
+            }
+        }
+    }
+    return contacts;
+}
+
+// Three mobs in a row, where pushing the first two apart already separates the last two. That second pair was found
+// overlapping before anything moved, but must not be pushed again; its overlap is negative by then, so pushing would
+// pull them back together.
+void checkChainedContacts(Checker& checker, World& world)
+{
+    EntitySystem entities(world);
+    const uint8_t flags = EntitySystem::COLLIDES_WITH_ENTITIES;
+
+    // `b` overlaps `a` by 0.2 and `c` by 0.02 along x, and more along the other axes; `a` and `c` are apart in y. The
+    // pairs are resolved in the order the entities were created, so `b` is first pushed 0.1 away from `a` and `c`.
+    const EntitySystem::EntityId a = entities.createEntity(glm::vec3(0.4f, -1.0f, 0.0f), HITBOX_MIN, HITBOX_MAX, flags);
+    const EntitySystem::EntityId b = entities.createEntity(glm::vec3(0.0f, 0.0f, 0.0f), HITBOX_MIN, HITBOX_MAX, flags);
+    const EntitySystem::EntityId c = entities.createEntity(glm::vec3(0.58f, 1.0f, 0.0f), HITBOX_MIN, HITBOX_MAX, flags);
+    entities.tick(DT);
+
+    checker.check(entities.getContacts().size() == 1, "the chained mobs had " +
+                                                          std::to_string(entities.getContacts().size()) +
+                                                          " contacts instead of only the first pair");
+    checker.check(entities.getPosition(a).x > 0.4f && entities.getPosition(b).x < -0.1f,
+                  "the first pair of chained mobs wasn't pushed apart");
+    checker.check(entities.getPosition(c) == glm::vec3(0.58f, 1.0f, 0.0f),
+                  "the last chained mob was moved after the pair was already separated");
+}
+
+} // namespace
+
+int main()
+{
+    const unsigned num_threads = std::max(1u, std::thread::hardware_concurrency());
+    World world(WORLD_SEED, CHUNK_SIZE, num_threads);
+    world.init(glm::vec3(0.0f), RADIUS);
+    world.getThreadPool().wait();
+
+    Checker checker;
+
+    // Drop the mobs from a few blocks above the ground, walking in random directions.
+    EntitySystem entities(world);
+    std::vector<EntitySystem::EntityId> ids;
+    ids.reserve(NUM_ENTITIES);
+    float min_ground_height = 0.0f;
+    std::mt19937 rng(RNG_SEED);
+    std::uniform_real_distribution<float> spawn_dist(-SPAWN_HALF_SIZE, SPAWN_HALF_SIZE);
+    std::uniform_real_distribution<float> drop_dist(1.0f, 6.0f);
+    std::uniform_real_distribution<float> walk_dist(-MAX_WALK_SPEED, MAX_WALK_SPEED);
+    while (ids.size() < NUM_ENTITIES)
+    {
+        const float x = spawn_dist(rng);
+        const float z = spawn_dist(rng);
+        const std::optional<float> ground_height = getGroundHeight(world, x, z);
+        checker.check(ground_height.has_value(), "no ground under a spawn position");
+        if (!ground_height.has_value())
+        {
+            break;
+        }
+
+        // The ground is only looked up under the center, so the hitbox can still reach into a taller column next to it.
+        const glm::vec3 pos(x, ground_height.value() + drop_dist(rng), z);
+        if (isInsideTerrain(world, Aabb3d(pos + HITBOX_MIN, pos + HITBOX_MAX)))
+        {
+            continue;
+        }
+        min_ground_height = std::min(min_ground_height, ground_height.value());
+
+        const EntitySystem::EntityId id = entities.createEntity(pos, HITBOX_MIN, HITBOX_MAX);
+        entities.setVelocity(id, glm::vec3(walk_dist(rng), 0.0f, walk_dist(rng)));
+        ids.push_back(id);
+    }
+
+    std::chrono::microseconds total_tick_duration{0};
+    std::chrono::microseconds max_tick_duration{0};
+    for (size_t i = 0; i < NUM_TICKS; ++i)
+    {
+        entities.tick(DT);
+        total_tick_duration += entities.getLastTickDuration();
+        max_tick_duration = std::max(max_tick_duration, entities.getLastTickDuration());
+    }
+
+    size_t num_on_floor = 0;
+    size_t num_inside_terrain = 0;
+    for (const EntitySystem::EntityId id : ids)
+    {
+        const glm::vec3 pos = entities.getPosition(id);
+        checker.check(std::isfinite(pos.x) && std::isfinite(pos.y) && std::isfinite(pos.z), "a mob's position is NaN");
+        checker.check(pos.y >= min_ground_height - 1.0f, "a mob fell through the ground");
+        if (isInsideTerrain(world, Aabb3d(pos + HITBOX_MIN, pos + HITBOX_MAX)))
+        {
+            ++num_inside_terrain;
+            checker.check(false, "mob " + std::to_string(id) + " is inside a block");
+        }
+        if (entities.getFlags(id) & EntitySystem::ON_FLOOR)
+        {
+            ++num_on_floor;
+        }
+    }
+    checker.check(static_cast<float>(num_on_floor) >= MIN_FRACTION_ON_FLOOR * static_cast<float>(ids.size()),
+                  "too few mobs landed on the ground");
+
+    // A tick without time only moves the mobs when resolving the contacts it found, so they are the contacts of the
+    // positions before it.
+    std::vector<std::pair<EntitySystem::EntityId, EntitySystem::EntityId>> brute_force_contacts =
+        getBruteForceContacts(entities, ids);
+    std::sort(brute_force_contacts.begin(), brute_force_contacts.end());
+    entities.tick(0.0f);
+    std::vector<std::pair<EntitySystem::EntityId, EntitySystem::EntityId>> contacts;
+    for (const auto& [a, b] : entities.getContacts())
+    {
+        contacts.emplace_back(std::min(a, b), std::max(a, b));
+    }
+    std::sort(contacts.begin(), contacts.end());
+
+    // Every overlapping pair is found, but a pair is only reported if it still overlaps when its turn comes, so one
+    // can only be missing if an earlier push moved one of its entities.
+    std::unordered_set<EntitySystem::EntityId> pushed_ids;
+    for (const auto& [a, b] : contacts)
+    {
+        pushed_ids.insert(a);
+        pushed_ids.insert(b);
+    }
+    for (const auto& pair : contacts)
+    {
+        checker.check(std::binary_search(brute_force_contacts.begin(), brute_force_contacts.end(), pair),
+                      "the spatial hash reported a pair that doesn't overlap");
+    }
+    for (const auto& pair : brute_force_contacts)
+    {
+        checker.check(std::binary_search(contacts.begin(), contacts.end(), pair) || pushed_ids.contains(pair.first) ||
+                          pushed_ids.contains(pair.second),
+                      "the spatial hash missed the pair of mobs " + std::to_string(pair.first) + " and " +
+                          std::to_string(pair.second));
+    }
+
+    checkChainedContacts(checker, world);
+
+    const double average_tick_ms =
+        static_cast<double>(total_tick_duration.count()) / static_cast<double>(NUM_TICKS) / 1000.0;
+    std::cout << ids.size() << " mobs on " << num_threads << " threads: " << average_tick_ms
+              << " ms per tick on average, " << static_cast<double>(max_tick_duration.count()) / 1000.0
+              << " ms at most; " << num_on_floor
+              << " on the ground, " << num_inside_terrain << " inside blocks, " << brute_force_contacts.size()
+              << " overlapping pairs (" << contacts.size() << " still overlapping when resolved); "
+              << checker.getNumChecks() << " checks, " << checker.getNumFailures() << " failed." << std::endl;
+
+    return (checker.getNumFailures() == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,246 @@
+// Records a scripted session in which the player drops into survival mode, walks and jumps across chunk boundaries
+// and adds and removes blocks, replays the recording into a fresh world with a different thread count and frame
+// pacing, and checks that both sessions end with the player in the same place and the same blocks.
+//
+// Both sessions run the game's own `Player`, `InputSampler`, `InputRecorder` and `InputReplay` on a window from GLFW's
+// null platform, which needs no display. Ticks follow the game's rules while input is recorded or replayed: they first
+// wait for the chunks they can touch, and the view only turns in ticks.
+
+#include "engine/input-recording.hpp"
+#include "player.hpp"
+#include "test-checker.hpp"
+#include "world.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+
+// The null platform has no input of its own, so the script feeds key and mouse button events in through the same
+// functions the other platforms call for theirs.
+extern "C"
+{
+    struct _GLFWwindow;
+    void _glfwInputKey(_GLFWwindow* window, int key, int scancode, int action, int mods);
+    void _glfwInputMouseClick(_GLFWwindow* window, int button, int action, int mods);
+}
+
+namespace
+{
+
+constexpr unsigned WORLD_SEED = 727;
+constexpr int CHUNK_SIZE = 16;
+constexpr unsigned RENDER_DISTANCE = 3;
+constexpr double TICKS_PER_SECOND = 60.0;
+constexpr size_t NUM_TICKS = 600;
+constexpr glm::vec3 SPAWN_POS{0.0f, 40.0f, 0.0f}; // Above the terrain; the player falls once in survival mode.
+constexpr float PLAYER_SPEED = 4.0f;
+
+struct ScriptedTick
+{
+    uint32_t keysDown = 0;         // Bits of `InputState::TRACKED_KEYS`, like in `InputState`.
+    uint32_t mouseButtonsDown = 0; // Bits of `InputState::TRACKED_MOUSE_BUTTONS`.
+    double cursorX = 0.0;
+    double cursorY = 0.0;
+};
+
+template <size_t N> constexpr uint32_t getBit(const std::array<int, N>& tracked, const int key_or_button)
+{
+    return 1u << static_cast<uint32_t>(std::find(tracked.begin(), tracked.end(), key_or_button) - tracked.begin());
+}
+
+// Switches to survival mode, looks down at the ground ahead while sweeping the view left and right, walks forward
+// (sometimes sprinting or jumping), and removes or adds a block every few ticks.
+ScriptedTick getScriptedTick(const size_t tick)
+{
+    constexpr uint32_t KEY_W = getBit(InputState::TRACKED_KEYS, GLFW_KEY_W);
+    constexpr uint32_t KEY_SPACE = getBit(InputState::TRACKED_KEYS, GLFW_KEY_SPACE);
+    constexpr uint32_t KEY_LEFT_CONTROL = getBit(InputState::TRACKED_KEYS, GLFW_KEY_LEFT_CONTROL);
+    constexpr uint32_t KEY_F1 = getBit(InputState::TRACKED_KEYS, GLFW_KEY_F1);
+    constexpr uint32_t MOUSE_BUTTON_LEFT = getBit(InputState::TRACKED_MOUSE_BUTTONS, GLFW_MOUSE_BUTTON_LEFT);
+    constexpr uint32_t MOUSE_BUTTON_RIGHT = getBit(InputState::TRACKED_MOUSE_BUTTONS, GLFW_MOUSE_BUTTON_RIGHT);
+
+    ScriptedTick scripted;
+    scripted.keysDown = (tick == 0) ? KEY_F1 : 0;
+    scripted.keysDown |= (tick % 120 < 100) ? KEY_W : 0;
+    scripted.keysDown |= (tick % 200 >= 150) ? KEY_LEFT_CONTROL : 0;
+    scripted.keysDown |= (tick % 90 < 3) ? KEY_SPACE : 0;
+    scripted.mouseButtonsDown = (tick % 7 == 0) ? MOUSE_BUTTON_LEFT : ((tick % 11 == 0) ? MOUSE_BUTTON_RIGHT : 0);
+    scripted.cursorX = 400.0 * std::sin(static_cast<double>(tick) * 0.02);
+    scripted.cursorY = std::min(static_cast<double>(tick), 100.0) * 10.0; // Ends up about 80 degrees down.
+    return scripted;
+}
+
+// Plays a script on a window like a user would.
+class ScriptedInput
+{
+  private:
+    Window& window;
+    ScriptedTick prevTick;
+
+    _GLFWwindow* getHandle() const
+    {
+        return reinterpret_cast<_GLFWwindow*>(window.getHandle());
+    }
+
+  public:
+    explicit ScriptedInput(Window& window) : window(window)
+    {
+        window.setInputMode(GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    }
+
+    // Sends the events between the previous tick's state and this one's.
+    void play(const ScriptedTick& scripted)
+    {
+        for (size_t i = 0; i < InputState::TRACKED_KEYS.size(); ++i)
+        {
+            const bool is_down = (scripted.keysDown >> i) & 1u;
+            if (is_down != static_cast<bool>((prevTick.keysDown >> i) & 1u))
+            {
+                _glfwInputKey(getHandle(), InputState::TRACKED_KEYS[i], 0, is_down ? GLFW_PRESS : GLFW_RELEASE, 0);
+            }
+        }
+        for (size_t i = 0; i < InputState::TRACKED_MOUSE_BUTTONS.size(); ++i)
+        {
+            const bool is_down = (scripted.mouseButtonsDown >> i) & 1u;
+            if (is_down != static_cast<bool>((prevTick.mouseButtonsDown >> i) & 1u))
+            {
+                _glfwInputMouseClick(
+                    getHandle(), InputState::TRACKED_MOUSE_BUTTONS[i], is_down ? GLFW_PRESS : GLFW_RELEASE, 0);
+            }
+        }
+        glfwSetCursorPos(window.getHandle(), scripted.cursorX, scripted.cursorY);
+        prevTick = scripted;
+    }
+};
+
+struct SessionResult
+{
+    uint64_t numTicks = 0;
+    size_t numEdits = 0;
+    glm::vec3 playerPosition{0.0f};
+    uint64_t blocksHash = 0;
+};
+
+class Session
+{
+  private:
+    Window window;
+    World world;
+    Player player;
+
+  public:
+    explicit Session(const unsigned num_threads)
+        : world(WORLD_SEED, CHUNK_SIZE, num_threads),
+          player(window, world, SPAWN_POS, PLAYER_SPEED, RENDER_DISTANCE)
+    {
+        world.init(SPAWN_POS, RENDER_DISTANCE);
+    }
+
+    Window& getWindow()
+    {
+        return window;
+    }
+
+    // What the game's tick callback does while input is recorded or replayed.
+    void tick(const float dt, const InputState& input)
+    {
+        world.waitForChunks(player.getTickBounds(dt));
+        player.tick(dt, input);
+    }
+
+    // What the main thread does between ticks; none of it may change the blocks.
+    void drawFrame(const float alpha)
+    {
+        player.update(alpha);
+        world.remeshDirtyChunks(std::chrono::microseconds(2000));
+        world.draw(player.getCamera().getFrustum());
+    }
+
+    SessionResult finish(const uint64_t num_ticks)
+    {
+        world.getThreadPool().wait();
+        // Every edit asks for its chunk to be remeshed, and nothing else does while no chunks are edited otherwise.
+        return SessionResult{num_ticks, world.getRemeshStats().requested, player.getPosition(), world.getBlocksHash()};
+    }
+};
+
+std::string toString(const glm::vec3& v)
+{
+    return "(" + std::to_string(v.x) + ", " + std::to_string(v.y) + ", " + std::to_string(v.z) + ")";
+}
+
+} // namespace
+
+int main()
+{
+    const float dt = static_cast<float>(1.0 / TICKS_PER_SECOND);
+    // Sessions get a window that needs no display.
+    glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "vmc-input-replay-test.vmcinput";
+
+    // Record live input with several workers and a varying number of frames per tick, like the game.
+    SessionResult recorded;
+    {
+        Session session(4);
+        ScriptedInput scripted_input(session.getWindow());
+        InputSampler sampler(session.getWindow());
+        InputRecorder recorder(path, InputRecordingHeader{WORLD_SEED, TICKS_PER_SECOND});
+        for (size_t i = 0; i < NUM_TICKS; ++i)
+        {
+            scripted_input.play(getScriptedTick(i));
+            const InputState input = sampler.sample();
+            recorder.record(input);
+            session.tick(dt, input);
+
+            const size_t num_frames = i % 3;
+            for (size_t j = 0; j < num_frames; ++j)
+            {
+                session.drawFrame(static_cast<float>(j + 1) / static_cast<float>(num_frames));
+            }
+        }
+        recorded = session.finish(recorder.getNumTicks());
+    }
+
+    // Replay with a single worker and one frame per tick.
+    SessionResult replayed;
+    bool does_header_match = false;
+    {
+        Session session(1);
+        InputReplay replay(path);
+        does_header_match =
+            replay.getHeader().worldSeed == WORLD_SEED && replay.getHeader().ticksPerSecond == TICKS_PER_SECOND;
+        for (std::optional<InputState> input = replay.next(); input.has_value(); input = replay.next())
+        {
+            session.tick(dt, input.value());
+            session.drawFrame(1.0f);
+        }
+        replayed = session.finish(replay.getNumTicks());
+    }
+    std::filesystem::remove(path);
+
+    std::cout << "Recorded " << recorded.numTicks << " ticks with " << recorded.numEdits << " edits, ending at "
+              << toString(recorded.playerPosition) << " (blocks hash " << std::hex << recorded.blocksHash << std::dec
+              << "); replayed " << replayed.numTicks << " ticks with " << replayed.numEdits << " edits, ending at "
+              << toString(replayed.playerPosition) << " (blocks hash " << std::hex << replayed.blocksHash << std::dec
+              << ")." << std::endl;
+
+    Checker checker;
+    checker.check(does_header_match, "the recording header doesn't match the session");
+    checker.check(recorded.numTicks == NUM_TICKS && replayed.numTicks == NUM_TICKS,
+                  "the replay didn't have every recorded tick");
+    checker.check(recorded.numEdits > 0, "the scripted session didn't edit any blocks");
+    checker.check(recorded.playerPosition.y < SPAWN_POS.y - 10.0f, "the player didn't fall in survival mode");
+    checker.check(replayed.numEdits == recorded.numEdits, "the replay made a different number of edits");
+    checker.check(replayed.playerPosition == recorded.playerPosition, "the replay ended somewhere else");
+    checker.check(replayed.blocksHash == recorded.blocksHash, "the replayed world differs from the recorded one");
+
+    return (checker.getNumFailures() == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,248 @@
+// Checks that the batched collision tests in `CollisionHandler`, which run the SIMD lane kernels (SSE2, or AVX2 when
+// built with `VMC_ENABLE_AVX2`) on full groups of boxes and the scalar lane kernel on the rest, give exactly the same
+// results as testing every box one by one with the scalar functions.
+//
+// Boxes are random, either anywhere or snapped to a half-block grid so that touching faces, shared edges, boxes that
+// already overlap and flat boxes come up often; velocities include zero on some or all axes. Batch sizes cover every
+// remainder modulo the lane width.
+
+#include "engine/physics/collision-handler.hpp"
+#include "engine/physics/simd-lanes.hpp"
+#include "test-checker.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr unsigned RNG_SEED = 12345;
+constexpr size_t NUM_CASES = 20000;
+constexpr size_t MAX_BATCH_SIZE = 4 * VmcSimd::SimdLanes::WIDTH + VmcSimd::SimdLanes::WIDTH - 1;
+constexpr float DT = 1.0f / 60.0f;
+
+struct Generator
+{
+    std::mt19937 rng{RNG_SEED};
+
+    float getFloat(const float min, const float max)
+    {
+        return std::uniform_real_distribution<float>(min, max)(rng);
+    }
+
+    // Multiples of 0.5 make exact ties between boxes and between times likely.
+    float getSnapped(const float min, const float max)
+    {
+        return std::round(getFloat(min, max) * 2.0f) * 0.5f;
+    }
+
+    bool getChance(const float probability)
+    {
+        return getFloat(0.0f, 1.0f) < probability;
+    }
+
+    Aabb3d getAabb(const bool is_snapped)
+    {
+        glm::vec3 min_bounds{};
+        glm::vec3 dim{};
+        for (glm::length_t axis = 0; axis < 3; ++axis)
+        {
+            min_bounds[axis] = is_snapped ? getSnapped(-3.0f, 3.0f) : getFloat(-3.0f, 3.0f);
+            dim[axis] = is_snapped ? getSnapped(0.0f, 2.0f) : getFloat(0.0f, 2.0f); // Possibly flat.
+        }
+        return Aabb3d(min_bounds, min_bounds + dim);
+    }
+
+    glm::vec3 getVelocity(const bool is_snapped)
+    {
+        glm::vec3 velocity{};
+        for (glm::length_t axis = 0; axis < 3; ++axis)
+        {
+            if (!getChance(0.3f))
+            {
+                velocity[axis] = is_snapped ? getSnapped(-240.0f, 240.0f) : getFloat(-240.0f, 240.0f);
+            }
+        }
+        return velocity;
+    }
+};
+
+// Both infinite or the same bits, apart from the sign of zero.
+bool isSameTime(const float a, const float b)
+{
+    return a == b || (std::isinf(a) && std::isinf(b) && std::signbit(a) == std::signbit(b));
+}
+
+std::string toString(const glm::vec3& v)
+{
+    return "(" + std::to_string(v.x) + ", " + std::to_string(v.y) + ", " + std::to_string(v.z) + ")";
+}
+
+std::string describeCase(const size_t case_index, const Aabb3d& a, const glm::vec3& velocity, const size_t batch_size)
+{
+    return "case " + std::to_string(case_index) + ", a " + toString(a.getMinBounds()) + "-" +
+           toString(a.getMaxBounds()) + ", velocity " + toString(velocity) + ", " + std::to_string(batch_size) +
+           " boxes";
+}
+
+void checkSweep(
+    Checker& checker,
+    const size_t case_index,
+    const Aabb3d& a,
+    const Aabb3dBatch& b,
+    const glm::vec3& velocity,
+    size_t& num_hits)
+{
+    // Reference: the first box with the smallest time, tested one by one.
+    float expected_t = std::numeric_limits<float>::infinity();
+    size_t expected_index = b.size();
+    glm::vec3 expected_normal{};
+    for (size_t i = 0; i < b.size(); ++i)
+    {
+        glm::vec3 normal{};
+        const float t = CollisionHandler::sweptAabbPerAxis(a, b.get(i), velocity, DT, normal);
+        if (t < expected_t)
+        {
+            expected_t = t;
+            expected_index = i;
+            expected_normal = normal;
+        }
+    }
+
+    glm::vec3 normal{};
+    size_t index = 0;
+    const float t = CollisionHandler::sweptAabbPerAxis(a, b, velocity, DT, normal, &index);
+
+    const std::string description = describeCase(case_index, a, velocity, b.size());
+    checker.check(!std::isnan(t), description + ": the batched sweep gave NaN");
+    checker.check(
+        isSameTime(t, expected_t),
+        description + ": batched time " + std::to_string(t) + " but scalar time " + std::to_string(expected_t));
+    checker.check(
+        index == expected_index,
+        description + ": batched box " + std::to_string(index) + " but scalar box " + std::to_string(expected_index));
+    checker.check(
+        normal == expected_normal,
+        description + ": batched normal " + toString(normal) + " but scalar normal " + toString(expected_normal));
+
+    if (expected_index != b.size())
+    {
+        ++num_hits;
+    }
+}
+
+void checkOverlap(
+    Checker& checker,
+    const size_t case_index,
+    const Aabb3d& a,
+    const Aabb3dBatch& b,
+    const bool consider_edges,
+    size_t& num_hits)
+{
+    std::vector<uint32_t> expected_indices;
+    for (size_t i = 0; i < b.size(); ++i)
+    {
+        if (CollisionHandler::shapeToShapeIntersect(a, b.get(i), consider_edges))
+        {
+            expected_indices.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    std::vector<uint32_t> indices = {UINT32_MAX}; // Results are appended after what is already there.
+    const size_t num_found = CollisionHandler::aabb3dBatchIntersect(a, b, indices, consider_edges);
+    indices.erase(indices.begin());
+
+    checker.check(
+        num_found == indices.size() && indices == expected_indices,
+        describeCase(case_index, a, glm::vec3(0.0f), b.size()) + ": batched overlap found " +
+            std::to_string(indices.size()) + " boxes but the scalar test found " +
+            std::to_string(expected_indices.size()) + (consider_edges ? " (with edges)" : " (without edges)"));
+
+    num_hits += expected_indices.size();
+}
+
+// Hand-picked cases around the boundaries of the sweep, each placed at every position of a batch so it is tested by
+// every lane and by the scalar remainder.
+void checkDegenerateSweeps(Checker& checker, size_t& num_hits)
+{
+    const Aabb3d a(glm::vec3(0.0f), glm::vec3(1.0f));
+    const std::vector<std::pair<Aabb3d, glm::vec3>> cases = {
+        {Aabb3d(glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(2.0f, 1.0f, 1.0f)), glm::vec3(6.0f, 0.0f, 0.0f)},  // Touching.
+        {Aabb3d(glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(2.0f, 1.0f, 1.0f)), glm::vec3(-6.0f, 0.0f, 0.0f)}, // Leaving.
+        {Aabb3d(glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(2.0f, 1.0f, 1.0f)), glm::vec3(0.0f)},              // Still.
+        {Aabb3d(glm::vec3(0.5f), glm::vec3(1.5f)), glm::vec3(0.0f)},                  // Overlapping and still.
+        {Aabb3d(glm::vec3(0.5f), glm::vec3(1.5f)), glm::vec3(0.0f, -6.0f, 0.0f)},     // Overlapping and moving.
+        {Aabb3d(glm::vec3(0.0f), glm::vec3(1.0f)), glm::vec3(3.0f, 3.0f, 3.0f)},      // Identical.
+        {Aabb3d(glm::vec3(1.1f, 0.0f, 0.0f), glm::vec3(1.1f, 1.0f, 1.0f)), glm::vec3(6.0f, 0.0f, 0.0f)}, // Flat.
+        {Aabb3d(glm::vec3(1.1f, 1.0f, 0.0f), glm::vec3(2.0f, 2.0f, 1.0f)), glm::vec3(6.0f, 6.0f, 0.0f)}, // Edge.
+        {Aabb3d(glm::vec3(1.1f, 0.0f, 0.0f), glm::vec3(2.0f, 1.0f, 1.0f)), glm::vec3(6.0f, 0.0f, 0.0f)}, // At `dt`.
+        {Aabb3d(glm::vec3(1.2f, 0.0f, 0.0f), glm::vec3(2.0f, 1.0f, 1.0f)), glm::vec3(6.0f, 0.0f, 0.0f)}, // Too far.
+        {Aabb3d(glm::vec3(-2.0f, 0.0f, 0.0f), glm::vec3(-1.0f, 1.0f, 1.0f)), glm::vec3(-1e30f, 0.0f, 0.0f)}, // Fast.
+        {Aabb3d(glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(2.0f, 1.0f, 1.0f)), glm::vec3(1e-30f, 0.0f, 0.0f)},   // Slow.
+        {Aabb3d(glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(2.0f, 1.0f, 1.0f)), glm::vec3(-0.0f, 0.0f, 0.0f)},    // -0.
+    };
+    const Aabb3d far_away(glm::vec3(100.0f), glm::vec3(101.0f));
+
+    size_t case_index = 0;
+    for (const auto& [box, velocity] : cases)
+    {
+        for (const size_t batch_size : {size_t{1}, VmcSimd::SimdLanes::WIDTH, VmcSimd::SimdLanes::WIDTH * 2 + 1})
+        {
+            for (size_t position = 0; position < batch_size; ++position)
+            {
+                Aabb3dBatch b;
+                for (size_t i = 0; i < batch_size; ++i)
+                {
+                    b.add((i == position) ? box : far_away);
+                }
+                checkSweep(checker, case_index, a, b, velocity, num_hits);
+            }
+        }
+        ++case_index;
+    }
+}
+
+} // namespace
+
+int main()
+{
+    Checker checker;
+    size_t num_sweep_hits = 0;
+    size_t num_overlap_hits = 0;
+
+    checkDegenerateSweeps(checker, num_sweep_hits);
+
+    Generator generator;
+    for (size_t case_index = 0; case_index < NUM_CASES; ++case_index)
+    {
+        const bool is_snapped = generator.getChance(0.5f);
+        const size_t batch_size = case_index % (MAX_BATCH_SIZE + 1);
+
+        const Aabb3d a = generator.getAabb(is_snapped);
+        const glm::vec3 velocity = generator.getVelocity(is_snapped);
+        Aabb3dBatch b;
+        for (size_t i = 0; i < batch_size; ++i)
+        {
+            b.add(generator.getAabb(is_snapped));
+        }
+
+        checkSweep(checker, case_index, a, b, velocity, num_sweep_hits);
+        checkOverlap(checker, case_index, a, b, true, num_overlap_hits);
+        checkOverlap(checker, case_index, a, b, false, num_overlap_hits);
+    }
+
+    std::cout << "Lane width " << VmcSimd::SimdLanes::WIDTH << ": " << checker.getNumChecks() << " checks ("
+              << num_sweep_hits << " sweeps and " << num_overlap_hits << " overlaps that hit), "
+              << checker.getNumFailures() << " failed." << std::endl;
+
+    // Make sure the random cases actually exercised the hits, not only the misses.
+    checker.check(num_sweep_hits > NUM_CASES / 20, "too few sweeps hit anything to be a meaningful test");
+    checker.check(num_overlap_hits > NUM_CASES / 20, "too few overlaps to be a meaningful test");
+
+    return (checker.getNumFailures() == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+// Counts the checks a test makes and reports the ones that fail on stderr.
+class Checker
+{
+  private:
+    static constexpr size_t MAX_REPORTED_FAILURES = 20;
+
+    size_t numChecks = 0;
+    size_t numFailures = 0;
+
+  public:
+    void check(const bool condition, const std::string& message)
+    {
+        ++numChecks;
+        if (!condition)
+        {
+            // Only the first few so a systematic mismatch doesn't flood the output.
+            if (numFailures < MAX_REPORTED_FAILURES)
+            {
+                std::cerr << "FAILED: " << message << std::endl;
+            }
+            ++numFailures;
+        }
+    }
+
+    size_t getNumChecks() const
+    {
+        return numChecks;
+    }
+
+    size_t getNumFailures() const
+    {
+        return numFailures;
+    }
+};
@@ -0,0 +1,266 @@
+// Times the CPU hot paths of the world and chunk code in isolation; nothing here touches GLFW or Vulkan.
+// Every case uses fixed seeds so runs are comparable, and the results are printed to stdout as JSON with the min,
+// median and 99th percentile time per operation in nanoseconds. Anything else (e.g. world loading progress) goes to
+// stderr.
+//
+// Usage: Vulkan-Minecraft-Clone-Benchmark [num_samples]
+
+#include "chunk.hpp"
+#include "engine/frustum.hpp"
+#include "world.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+constexpr unsigned WORLD_SEED = 727;
+constexpr unsigned RNG_SEED = 12345;
+constexpr int CHUNK_SIZE = 16;
+constexpr unsigned WORLD_RADIUS = 4;
+constexpr glm::vec3 WORLD_ORIGIN{0.0f, 2.0f, 0.0f};
+
+struct Result
+{
+    std::string name;
+    size_t numSamples;
+    size_t opsPerSample;
+    double min; // In nanoseconds per operation.
+    double median;
+    double p99;
+};
+
+// Keeps the measured work from being optimized away.
+volatile size_t sink = 0;
+
+// Runs `run_sample(i)`, which performs `ops_per_sample` operations, `num_samples` times (after one warm-up sample) and
+// summarizes the time per operation.
+template <typename Function>
+Result measure(const std::string& name, const size_t num_samples, const size_t ops_per_sample, Function&& run_sample)
+{
+    run_sample(0);
+
+    std::vector<double> times;
+    times.reserve(num_samples);
+    for (size_t i = 0; i < num_samples; ++i)
+    {
+        const auto start_time = std::chrono::steady_clock::now();
+        run_sample(i);
+        const auto end_time = std::chrono::steady_clock::now();
+
+        const std::chrono::duration<double, std::nano> elapsed = end_time - start_time;
+        times.push_back(elapsed.count() / static_cast<double>(ops_per_sample));
+    }
+    std::sort(times.begin(), times.end());
+
+    const size_t p99_index = static_cast<size_t>(std::ceil(0.99 * static_cast<double>(times.size()))) - 1;
+    return {name, num_samples, ops_per_sample, times.front(), times[times.size() / 2], times[p99_index]};
+}
+
+// Centers of chunks that contain the terrain surface, found by scanning down from above the highest possible terrain.
+std::vector<ChunkCenter> findSurfaceChunks(const World& world, const int num_chunks_per_axis)
+{
+    std::vector<ChunkCenter> centers;
+    for (int x = 0; x < num_chunks_per_axis; ++x)
+    {
+        for (int z = 0; z < num_chunks_per_axis; ++z)
+        {
+            for (int y = 4; y >= -4; --y)
+            {
+                const glm::vec3 pos = glm::vec3(x, y, z) * static_cast<float>(CHUNK_SIZE);
+                const ChunkCenter cc = world.getPosToChunkCenter(pos);
+                const Chunk chunk(world.getTerrainHeightNoise(), cc, CHUNK_SIZE);
+                if (!chunk.getModel().getVertices().empty())
+                {
+                    centers.push_back(cc);
+                    break;
+                }
+            }
+        }
+    }
+    return centers;
+}
+
+void printResults(const std::vector<Result>& results)
+{
+    std::cout << "{\n";
+    std::cout << "  \"unit\": \"ns/op\",\n";
+    std::cout << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& result = results[i];
+        std::cout << "    {\"name\": \"" << result.name << "\", \"samples\": " << result.numSamples
+                  << ", \"ops_per_sample\": " << result.opsPerSample << ", \"min\": " << result.min
+                  << ", \"median\": " << result.median << ", \"p99\": " << result.p99 << "}"
+                  << ((i + 1 < results.size()) ? "," : "") << "\n";
+    }
+    std::cout << "  ]\n";
+    std::cout << "}" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const size_t num_samples = (argc > 1) ? std::max(std::strtoul(argv[1], nullptr, 10), 1ul) : 200;
+
+    // The world reports its progress on stdout, which is reserved for the results.
+    std::streambuf* const stdout_buffer = std::cout.rdbuf(std::cerr.rdbuf());
+    World world(WORLD_SEED, CHUNK_SIZE, 1);
+    world.init(WORLD_ORIGIN, WORLD_RADIUS);
+    world.getThreadPool().wait(); // Measure with an idle pool rather than next to the chunks still streaming in.
+    std::cout.rdbuf(stdout_buffer);
+
+    const std::vector<ChunkCenter> surface_chunks = findSurfaceChunks(world, 4);
+    std::mt19937 rng(RNG_SEED);
+    std::vector<Result> results;
+
+    // Chunk generation.
+    results.push_back(measure("chunk_construct", num_samples, surface_chunks.size(), [&](const size_t) {
+        for (const auto& cc : surface_chunks)
+        {
+            const Chunk chunk(world.getTerrainHeightNoise(), cc, CHUNK_SIZE);
+            sink = sink + chunk.isBlockPresent(cc);
+        }
+    }));
+
+    // Meshing.
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    for (const auto& cc : surface_chunks)
+    {
+        chunks.push_back(std::make_unique<Chunk>(world.getTerrainHeightNoise(), cc, CHUNK_SIZE));
+    }
+    results.push_back(measure("chunk_get_model", num_samples, chunks.size(), [&](const size_t) {
+        for (const auto& chunk : chunks)
+        {
+            sink = sink + chunk->getModel().getVertices().size();
+        }
+    }));
+
+    // Block edits; each operation adds and then removes a block (or the reverse) so the chunk ends up unchanged.
+    {
+        constexpr size_t num_edits = 64;
+        Chunk& chunk = *chunks.front();
+        const glm::vec3 min_pos = chunk.getCenter() - glm::vec3(CHUNK_SIZE * 0.5f - 1.0f);
+        std::uniform_int_distribution<int> local_dist(0, CHUNK_SIZE - 3); // Away from the edges.
+
+        std::vector<glm::vec3> edit_positions;
+        for (size_t i = 0; i < num_edits; ++i)
+        {
+            edit_positions.push_back(min_pos + glm::vec3(local_dist(rng), local_dist(rng), local_dist(rng)));
+        }
+
+        results.push_back(measure("chunk_add_remove_block", num_samples, num_edits, [&](const size_t) {
+            for (const auto& pos : edit_positions)
+            {
+                if (chunk.isBlockPresent(pos))
+                {
+                    chunk.removeBlock(pos);
+                    chunk.addBlock(pos);
+                }
+                else
+                {
+                    chunk.addBlock(pos);
+                    chunk.removeBlock(pos);
+                }
+            }
+        }));
+    }
+
+    // Block picking from around the spawn point.
+    {
+        constexpr size_t num_rays = 256;
+        std::uniform_real_distribution<float> unit_dist(-1.0f, 1.0f);
+        std::vector<Ray> rays;
+        for (size_t i = 0; i < num_rays; ++i)
+        {
+            const glm::vec3 origin = WORLD_ORIGIN + glm::vec3(unit_dist(rng), unit_dist(rng), unit_dist(rng)) * 8.0f;
+            const glm::vec3 direction(unit_dist(rng), unit_dist(rng) - 0.5f, unit_dist(rng)); // Mostly downwards.
+            rays.emplace_back(origin, glm::normalize(direction), 0.0f, 8.0f);
+        }
+
+        results.push_back(measure("world_get_reachable_block", num_samples, num_rays, [&](const size_t) {
+            for (const auto& ray : rays)
+            {
+                sink = sink + world.getReachableBlock(ray).has_value();
+            }
+        }));
+    }
+
+    // Swept entity collisions; player-sized hitboxes falling and moving sideways.
+    {
+        constexpr size_t num_entities = 256;
+        constexpr float delta = 1.0f / 60.0f;
+        std::uniform_real_distribution<float> unit_dist(-1.0f, 1.0f);
+        const Aabb3d hitbox(glm::vec3(-0.3f, -1.5f, -0.3f), glm::vec3(0.3f, 0.3f, 0.3f));
+
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> velocities;
+        for (size_t i = 0; i < num_entities; ++i)
+        {
+            positions.push_back(WORLD_ORIGIN + glm::vec3(unit_dist(rng), unit_dist(rng), unit_dist(rng)) * 16.0f);
+            velocities.push_back(glm::vec3(unit_dist(rng) * 4.0f, -20.0f, unit_dist(rng) * 4.0f));
+        }
+
+        results.push_back(measure("world_does_entity_intersect", num_samples, num_entities, [&](const size_t) {
+            for (size_t i = 0; i < num_entities; ++i)
+            {
+                Aabb3d entity_hitbox = hitbox;
+                entity_hitbox.translate(positions[i]);
+                float new_delta = delta;
+                sink = sink + world.doesEntityIntersect(velocities[i], delta, entity_hitbox, new_delta);
+            }
+        }));
+    }
+
+    // Frustum culling of chunk bounds within a render distance of 16.
+    {
+        const glm::vec3 eye = WORLD_ORIGIN;
+        const glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(1.0f, -0.2f, 0.3f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const glm::mat4 proj = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 16.0f * CHUNK_SIZE);
+        const Frustum frustum(proj * view);
+
+        std::vector<Aabb3d> chunk_bounds;
+        Aabb3dBatch chunk_bounds_batch;
+        const float chunk_extent = CHUNK_SIZE * 0.5f;
+        for (int x = -16; x <= 16; ++x)
+        {
+            for (int y = -16; y <= 16; ++y)
+            {
+                for (int z = -16; z <= 16; ++z)
+                {
+                    const glm::vec3 cc = glm::vec3(x, y, z) * static_cast<float>(CHUNK_SIZE);
+                    chunk_bounds.emplace_back(cc - chunk_extent, cc + chunk_extent);
+                    chunk_bounds_batch.add(chunk_bounds.back());
+                }
+            }
+        }
+
+        results.push_back(measure("frustum_is_aabb_inside", num_samples, chunk_bounds.size(), [&](const size_t) {
+            for (const auto& aabb : chunk_bounds)
+            {
+                sink = sink + frustum.isAabbInside(aabb);
+            }
+        }));
+
+        std::vector<uint64_t> visible;
+        results.push_back(measure("frustum_cull_aabbs", num_samples, chunk_bounds.size(), [&](const size_t) {
+            frustum.cullAabbs(chunk_bounds_batch, visible);
+            sink = sink + visible.front();
+        }));
+    }
+
+    printResults(results);
+
+    return EXIT_SUCCESS;
+}
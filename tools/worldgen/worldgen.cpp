@@ -0,0 +1,173 @@
+// Generates and meshes a region of the world without a window or GPU and reports the throughput of the chunk pipeline,
+// to size the number of worker threads and to compare generator changes against a baseline.
+// The report is printed to stdout as JSON; latencies are in microseconds.
+//
+// Usage: Vulkan-Minecraft-Clone-WorldGen [--seed N] [--radius N] [--threads N] [--chunk-cache DIR]
+
+#include "world.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+
+constexpr int CHUNK_SIZE = 16;
+constexpr glm::vec3 ORIGIN{0.0f, 2.0f, 0.0f};
+
+struct Options
+{
+    unsigned seed = 727;
+    unsigned radius = 8;
+    unsigned numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::optional<std::filesystem::path> chunkCachePath;
+};
+
+bool parseOptions(const int argc, char* argv[], Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << arg << "." << std::endl;
+            return false;
+        }
+
+        if (arg == "--chunk-cache")
+        {
+            options.chunkCachePath = argv[++i];
+            continue;
+        }
+
+        const unsigned value = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        if (arg == "--seed")
+        {
+            options.seed = value;
+        }
+        else if (arg == "--radius")
+        {
+            options.radius = value;
+        }
+        else if (arg == "--threads")
+        {
+            options.numThreads = std::max(value, 1u);
+        }
+        else
+        {
+            std::cerr << "Unknown option " << arg << "." << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// In bytes.
+size_t getPeakResidentSetSize()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters{};
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss); // Already in bytes.
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+double toMicroseconds(const std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+void printLatencies(const std::string& name, std::vector<std::chrono::nanoseconds> samples, const bool is_last)
+{
+    std::cout << "    \"" << name << "\": {\"count\": " << samples.size();
+    if (!samples.empty())
+    {
+        std::sort(samples.begin(), samples.end());
+        const auto percentile = [&](const double p) {
+            const size_t index = static_cast<size_t>(p * static_cast<double>(samples.size() - 1));
+            return toMicroseconds(samples[index]);
+        };
+        std::cout << ", \"min\": " << toMicroseconds(samples.front()) << ", \"median\": " << percentile(0.5)
+                  << ", \"p99\": " << percentile(0.99) << ", \"max\": " << toMicroseconds(samples.back());
+    }
+    std::cout << "}" << (is_last ? "" : ",") << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--seed N] [--radius N] [--threads N] [--chunk-cache DIR]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    World world(options.seed, CHUNK_SIZE, options.numThreads);
+    world.setStageTimingsEnabled(true);
+    if (options.chunkCachePath.has_value() && !world.enableChunkCache(options.chunkCachePath.value()))
+    {
+        std::cerr << "Failed to open chunk cache " << options.chunkCachePath.value() << "." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Requesting the chunks schedules generation, and each generated chunk schedules the meshes it completes, so the
+    // pool is idle once every chunk that can be meshed is.
+    const auto start_time = std::chrono::steady_clock::now();
+    const unsigned num_requested = world.updateChunks(ORIGIN, options.radius);
+    world.getThreadPool().wait();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+
+    const World::StageTimings timings = world.getStageTimings();
+    const double seconds = elapsed.count();
+
+    std::cout << "{\n";
+    std::cout << "  \"seed\": " << options.seed << ",\n";
+    std::cout << "  \"radius\": " << options.radius << ",\n";
+    std::cout << "  \"threads\": " << options.numThreads << ",\n";
+    std::cout << "  \"chunks_requested\": " << num_requested << ",\n";
+    std::cout << "  \"chunks_generated\": " << timings.generated.size() << ",\n";
+    std::cout << "  \"chunks_meshed\": " << timings.meshed.size() << ",\n";
+    if (const ChunkCache* chunk_cache = world.getChunkCache())
+    {
+        std::cout << "  \"chunk_cache_hits\": " << chunk_cache->getNumHits() << ",\n";
+        std::cout << "  \"chunk_cache_misses\": " << chunk_cache->getNumMisses() << ",\n";
+    }
+    std::cout << "  \"seconds\": " << seconds << ",\n";
+    std::cout << "  \"chunks_per_second\": " << (static_cast<double>(timings.generated.size()) / seconds) << ",\n";
+    std::cout << "  \"meshes_per_second\": " << (static_cast<double>(timings.meshed.size()) / seconds) << ",\n";
+    std::cout << "  \"peak_rss_bytes\": " << getPeakResidentSetSize() << ",\n";
+    std::cout << "  \"stage_latency_us\": {\n";
+    printLatencies("queued", timings.queued, false);
+    printLatencies("generated", timings.generated, false);
+    printLatencies("meshed", timings.meshed, true);
+    std::cout << "  }\n";
+    std::cout << "}" << std::endl;
+
+    return EXIT_SUCCESS;
+}